@@ -1,10 +1,14 @@
 #pragma once
 
+#include <charconv>
+#include <concepts>
+#include <cstdint>
 #include <optional>
 #include <stdexcept>
 #include <string>
 #include <string_view>
 #include <unordered_map>
+#include <utility>
 #include <variant>
 #include <vector>
 
@@ -14,6 +18,40 @@ namespace json
 {
     struct value;
 
+    // An object member name whose hash is computed once, up front. Looking up the same names in many objects (e.g.
+    // 'object_get(obj, idKey)' in a loop) then avoids rehashing the name for every lookup. E.g.
+    //
+    //      static const json::key idKey("id");
+    //      for (auto& obj : objects) if (auto id = json::object_get(obj, idKey)) { ... }
+    //
+    // The key does not own the name, so the name must outlive it. String literals are the typical use
+    class key
+    {
+    public:
+        explicit key(std::string_view name) noexcept : name(name), hash_value(std::hash<std::string_view>{}(name))
+        {
+        }
+
+        std::string_view view() const noexcept
+        {
+            return name;
+        }
+
+        std::size_t hash() const noexcept
+        {
+            return hash_value;
+        }
+
+        friend bool operator==(const key& lhs, std::string_view rhs) noexcept
+        {
+            return lhs.name == rhs;
+        }
+
+    private:
+        std::string_view name;
+        std::size_t hash_value;
+    };
+
     namespace details
     {
         struct string_hash
@@ -24,12 +62,112 @@ namespace json
             {
                 return std::hash<std::string_view>{}(str);
             }
+
+            // NOTE: 'key' uses the same hash function, so its cached hash can be used as-is
+            std::size_t operator()(const key& k) const noexcept
+            {
+                return k.hash();
+            }
         };
     }
 
+    // A JSON number, stored as the text of its lexeme. Conversion to a native type only happens on request, using the
+    // same rules as 'parse_number', so numbers that are never read are never converted, and integers that cannot be
+    // represented by a 'double' (e.g. 64-bit IDs) are not corrupted. E.g.
+    //
+    //      if (auto id = num.get<std::uint64_t>()) { ... }
+    //
+    // Numbers compare equal if they have the same numeric value, regardless of how they are written (e.g. '1' and
+    // '1.0'). Numbers whose value is exactly a 64-bit (signed or unsigned) integer are compared exactly, and never
+    // equal a number that is not. All other numbers are compared by their nearest 'double', so e.g. '0.1' and
+    // '0.10000000000000000001' are equal. This keeps equality transitive
+    class number
+    {
+    public:
+        number() : text_value("0"), integral(true)
+        {
+        }
+
+        number(double value)
+        {
+            char buffer[32];
+            auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+            set_text(std::string_view(buffer, end - buffer));
+        }
+
+        template <std::integral T>
+            requires(!std::is_same_v<T, bool>)
+        number(T value)
+        {
+            char buffer[24];
+            auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+            set_text(std::string_view(buffer, end - buffer));
+        }
+
+        // Creates a number from the text of a JSON number token. The text is not validated; if it is not a valid JSON
+        // number, all conversions will fail
+        static number from_text(std::string_view text)
+        {
+            number result;
+            result.set_text(text);
+            return result;
+        }
+
+        // Converts to 'T', failing if the value cannot be represented exactly by an integral type, or is out of range
+        template <Number T>
+        std::optional<T> get() const noexcept
+        {
+            T result;
+            if (!details::parse_number_text(text_value, result)) return std::nullopt;
+            return result;
+        }
+
+        const std::string& text() const noexcept
+        {
+            return text_value;
+        }
+
+        // True if the number is written without a fraction or exponent
+        bool is_integral() const noexcept
+        {
+            return integral;
+        }
+
+        friend bool operator==(const number& lhs, const number& rhs) noexcept
+        {
+            if (lhs.text_value == rhs.text_value) return true;
+
+            // Distinct 64-bit integers may convert to the same 'double', so they must be compared exactly
+            auto lhsInteger = lhs.exact_integer();
+            auto rhsInteger = rhs.exact_integer();
+            if (lhsInteger || rhsInteger) return lhsInteger == rhsInteger;
+
+            auto lhsDouble = lhs.get<double>();
+            auto rhsDouble = rhs.get<double>();
+            return lhsDouble && rhsDouble && (*lhsDouble == *rhsDouble);
+        }
+
+    private:
+        // The sign and magnitude of the number, if it is exactly a 64-bit signed or unsigned integer
+        std::optional<std::pair<bool, std::uint64_t>> exact_integer() const noexcept
+        {
+            if (auto u = get<std::uint64_t>()) return std::pair(false, *u);
+            if (auto i = get<std::int64_t>()) return std::pair(*i < 0, 0 - static_cast<std::uint64_t>(*i));
+            return std::nullopt;
+        }
+
+        void set_text(std::string_view text)
+        {
+            text_value = text;
+            integral = !text.empty() && (text.find_first_not_of("-0123456789") == std::string_view::npos);
+        }
+
+        std::string text_value;
+        bool integral = false;
+    };
+
     using null = std::nullptr_t;
     using boolean = bool;
-    using number = double;
     using string = std::string;
     using array = std::vector<value>;
     using object = std::unordered_map<string, value, details::string_hash, std::equal_to<>>;
@@ -119,6 +257,17 @@ namespace json
         }
     };
 
+    // Stores the text of the number without converting it. See 'json::number'
+    template <InputStream InputStreamT>
+    inline bool parse_number(lexer<InputStreamT>& lexer, number& target) noexcept
+    {
+        if (lexer.current_token != lexer_token::number) return false;
+
+        target = number::from_text(lexer.string_value);
+        lexer.advance();
+        return true;
+    }
+
     template <InputStream InputStreamT>
     inline bool parse_value(lexer<InputStreamT>& lexer, value& target) noexcept
     {
@@ -164,10 +313,7 @@ namespace json
             lexer.advance();
             return true;
 
-        case lexer_token::number: {
-            auto& num = target.data.emplace<number>(0);
-            return parse_number(lexer, num);
-        }
+        case lexer_token::number: return parse_number(lexer, target.data.emplace<number>());
 
         default: return false;
         }
@@ -212,4 +358,267 @@ namespace json
 
         return value->get<T>();
     }
+
+    inline value* object_get(object& obj, const key& name) noexcept
+    {
+        auto itr = obj.find(name);
+        if (itr == obj.end())
+        {
+            return nullptr;
+        }
+
+        return &itr->second;
+    }
+
+    inline const value* object_get(const object& obj, const key& name) noexcept
+    {
+        auto itr = obj.find(name);
+        if (itr == obj.end())
+        {
+            return nullptr;
+        }
+
+        return &itr->second;
+    }
+
+    template <typename T>
+    inline T* object_get_as(object& obj, const key& name) noexcept
+    {
+        auto value = object_get(obj, name);
+        if (!value) return nullptr;
+
+        return value->get<T>();
+    }
+
+    template <typename T>
+    inline const T* object_get_as(const object& obj, const key& name) noexcept
+    {
+        auto value = object_get(obj, name);
+        if (!value) return nullptr;
+
+        return value->get<T>();
+    }
+
+    namespace details
+    {
+        inline bool values_equal(const value& lhs, const value& rhs) noexcept
+        {
+            if (&lhs == &rhs) return true;
+            if (lhs.data.index() != rhs.data.index()) return false;
+
+            if (auto lhsArr = lhs.get_array())
+            {
+                auto& rhsArr = *rhs.get_array();
+                if (lhsArr->size() != rhsArr.size()) return false;
+                for (std::size_t i = 0; i < lhsArr->size(); ++i)
+                {
+                    if (!values_equal((*lhsArr)[i], rhsArr[i])) return false;
+                }
+
+                return true;
+            }
+            else if (auto lhsObj = lhs.get_object())
+            {
+                auto& rhsObj = *rhs.get_object();
+                if (lhsObj->size() != rhsObj.size()) return false;
+                for (auto& pair : *lhsObj)
+                {
+                    auto itr = rhsObj.find(pair.first);
+                    if ((itr == rhsObj.end()) || !values_equal(pair.second, itr->second)) return false;
+                }
+
+                return true;
+            }
+
+            return std::visit(
+                [&](auto& lhsData) {
+                    using T = std::decay_t<decltype(lhsData)>;
+                    if constexpr (std::is_same_v<T, std::monostate> || std::is_same_v<T, null>) return true;
+                    else if constexpr (std::is_same_v<T, array> || std::is_same_v<T, object>) return false;
+                    else return lhsData == *std::get_if<T>(&rhs.data);
+                },
+                lhs.data);
+        }
+
+        constexpr std::size_t hash_combine(std::size_t seed, std::size_t hash) noexcept
+        {
+            return seed ^ (hash + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+        }
+
+        // Spreads the bits of 'hash' so that summing the hashes of object members does not cancel out
+        constexpr std::size_t hash_mix(std::size_t hash) noexcept
+        {
+            std::uint64_t x = hash;
+            x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+            x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+            return static_cast<std::size_t>(x ^ (x >> 31));
+        }
+    }
+
+    // Structural equality. Objects compare equal if they hold the same members, regardless of order
+    inline bool operator==(const value& lhs, const value& rhs) noexcept
+    {
+        return details::values_equal(lhs, rhs);
+    }
+
+    // Structural hash, consistent with 'operator=='. Object members are combined in an order independent way, so equal
+    // objects hash the same regardless of iteration order
+    inline std::size_t hash(const value& val) noexcept
+    {
+        auto result = details::hash_mix(val.data.index());
+        if (auto arr = val.get_array())
+        {
+            result = details::hash_combine(result, arr->size());
+            for (auto& element : *arr) result = details::hash_combine(result, hash(element));
+        }
+        else if (auto obj = val.get_object())
+        {
+            std::size_t members = 0;
+            for (auto& pair : *obj)
+            {
+                auto memberHash = details::hash_combine(details::string_hash{}(pair.first), hash(pair.second));
+                members += details::hash_mix(memberHash);
+            }
+
+            result = details::hash_combine(details::hash_combine(result, obj->size()), members);
+        }
+        else if (auto str = val.get_string())
+        {
+            result = details::hash_combine(result, details::string_hash{}(*str));
+        }
+        else if (auto num = val.get_number())
+        {
+            // Numbers compare equal by value, so hash the value rather than the text. Positive and negative zero
+            // compare equal, so they must hash the same. Numbers that are out of range only equal identical text
+            if (auto d = num->get<double>())
+            {
+                result = details::hash_combine(result, std::hash<double>{}((*d == 0) ? 0.0 : *d));
+            }
+            else
+            {
+                result = details::hash_combine(result, details::string_hash{}(num->text()));
+            }
+        }
+        else if (auto b = val.get_boolean())
+        {
+            result = details::hash_combine(result, *b);
+        }
+
+        return result;
+    }
+
+    // Heap memory held by a 'json::value', broken down by category. All values are in bytes. Container sizes are
+    // estimates based on the layout used by the standard library implementation, so they will be exact for libstdc++
+    // but approximate elsewhere
+    struct memory_footprint
+    {
+        std::size_t strings = 0; // String values, object keys, and number text that do not fit in the small buffer
+        std::size_t array_storage = 0; // Array element buffers, including unused capacity
+        std::size_t object_buckets = 0; // Object hash table bucket arrays
+        std::size_t object_nodes = 0; // Object hash table nodes, each holding one member
+
+        // Bytes within array storage and object nodes that are reserved by the 'value' variant but unused by the type
+        // it holds, e.g. a 'boolean' in a slot large enough to hold an 'object'. This is already accounted for in the
+        // categories above, so it is not included in 'total'
+        std::size_t variant_overhead = 0;
+
+        constexpr std::size_t total() const noexcept
+        {
+            return strings + array_storage + object_buckets + object_nodes;
+        }
+    };
+
+    namespace details
+    {
+#if defined(_MSC_VER)
+        // Nodes are part of a doubly linked list and buckets hold the first and last node, plus one sentinel node
+        struct object_node
+        {
+            void* next;
+            void* prev;
+            object::value_type value;
+        };
+
+        inline constexpr std::size_t object_bucket_size = 2 * sizeof(void*);
+        inline constexpr std::size_t object_fixed_nodes = 1;
+#elif defined(_LIBCPP_VERSION)
+        struct object_node
+        {
+            void* next;
+            std::size_t hash;
+            object::value_type value;
+        };
+
+        inline constexpr std::size_t object_bucket_size = sizeof(void*);
+        inline constexpr std::size_t object_fixed_nodes = 0;
+#else
+        // NOTE: 'string_hash' is noexcept, so libstdc++ does not cache hash codes in the nodes
+        struct object_node
+        {
+            void* next;
+            object::value_type value;
+        };
+
+        inline constexpr std::size_t object_bucket_size = sizeof(void*);
+        inline constexpr std::size_t object_fixed_nodes = 0;
+#endif
+
+        inline std::size_t string_heap_size(const string& str) noexcept
+        {
+            // Strings that use the small string buffer store their data within the object itself
+            auto data = reinterpret_cast<const char*>(str.data());
+            auto self = reinterpret_cast<const char*>(&str);
+            if ((data >= self) && (data < self + sizeof(str))) return 0;
+            return str.capacity() + 1;
+        }
+
+        inline std::size_t unused_variant_bytes(const value& val) noexcept
+        {
+            return sizeof(value) - std::visit([](auto& data) { return sizeof(data); }, val.data);
+        }
+
+        inline void add_memory_usage(const value& val, memory_footprint& result) noexcept
+        {
+            if (auto str = val.get_string())
+            {
+                result.strings += string_heap_size(*str);
+            }
+            else if (auto num = val.get_number())
+            {
+                result.strings += string_heap_size(num->text());
+            }
+            else if (auto arr = val.get_array())
+            {
+                result.array_storage += arr->capacity() * sizeof(value);
+                for (auto& element : *arr)
+                {
+                    result.variant_overhead += unused_variant_bytes(element);
+                    add_memory_usage(element, result);
+                }
+            }
+            else if (auto obj = val.get_object())
+            {
+#if defined(__GLIBCXX__)
+                // libstdc++ uses a bucket embedded in the container itself when there is only one
+                if (obj->bucket_count() > 1)
+#endif
+                    result.object_buckets += obj->bucket_count() * object_bucket_size;
+                result.object_nodes += (obj->size() + object_fixed_nodes) * sizeof(object_node);
+                for (auto& pair : *obj)
+                {
+                    result.strings += string_heap_size(pair.first);
+                    result.variant_overhead += unused_variant_bytes(pair.second);
+                    add_memory_usage(pair.second, result);
+                }
+            }
+        }
+    }
+
+    // Calculates the heap memory held by 'val'. This does not include 'sizeof(value)' for 'val' itself
+    inline memory_footprint memory_usage(const value& val) noexcept
+    {
+        memory_footprint result;
+        details::add_memory_usage(val, result);
+        return result;
+    }
 }
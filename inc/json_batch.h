@@ -0,0 +1,216 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "json.h"
+
+namespace json
+{
+    // Parses batches of many small, independent documents (e.g. queue messages). The result storage and each worker's
+    // lexer are kept across batches, so the per-message cost is only that of building the values themselves. E.g.
+    //
+    //      json::batch_parser parser(4);
+    //      parser.parse(messages);
+    //      for (std::size_t i = 0; i < messages.size(); ++i)
+    //          if (parser.succeeded(i)) consume(parser.results()[i]);
+    //
+    // Batches are split across 'thread_count' threads, with the calling thread processing the first share itself. The
+    // other threads are started once, when the parser is constructed, and wait for work between batches
+    class batch_parser
+    {
+    public:
+        // Batches smaller than this per thread are not worth the cost of waking a thread
+        static constexpr std::size_t min_messages_per_thread = 64;
+
+        explicit batch_parser(std::size_t threadCount = 1)
+        {
+            workers.resize(threadCount ? threadCount : 1);
+            for (auto& w : workers) w = std::make_unique<worker>();
+
+            threads.reserve(workers.size() - 1);
+            try
+            {
+                for (std::size_t i = 1; i < workers.size(); ++i) threads.emplace_back([this, i] { run(i); });
+            }
+            catch (...)
+            {
+                stop();
+                throw;
+            }
+        }
+
+        ~batch_parser()
+        {
+            stop();
+        }
+
+        batch_parser(const batch_parser&) = delete;
+        batch_parser& operator=(const batch_parser&) = delete;
+
+        std::size_t thread_count() const noexcept
+        {
+            return workers.size();
+        }
+
+        // Parses each message, which must consist of exactly one JSON value optionally surrounded by whitespace, into
+        // the corresponding element of 'results'. Messages that fail to parse leave an uninitialized ('monostate')
+        // value. Returns the number of messages that failed. Results from the previous batch are overwritten. If any
+        // thread throws (e.g. 'std::bad_alloc'), the exception is rethrown here once all threads have finished
+        std::size_t parse(std::span<const std::string_view> messages)
+        {
+            values.resize(messages.size());
+            status.resize(messages.size());
+
+            auto threadCount = std::min(workers.size(), messages.size() / min_messages_per_thread);
+            if (threadCount == 0) threadCount = 1;
+            auto chunkSize = (messages.size() + threadCount - 1) / threadCount;
+
+            if (threadCount > 1)
+            {
+                std::lock_guard lock(mutex);
+                batch = messages;
+                batch_chunk_size = chunkSize;
+                batch_threads = threadCount;
+                pending = threadCount - 1;
+                ++generation;
+                start_condition.notify_all();
+            }
+
+            // The other threads are still writing to the results, so wait for them even if this throws
+            try
+            {
+                parse_range(*workers[0], messages, 0, chunkSize);
+            }
+            catch (...)
+            {
+                record_error();
+            }
+
+            if (threadCount > 1)
+            {
+                std::unique_lock lock(mutex);
+                done_condition.wait(lock, [&] { return pending == 0; });
+            }
+
+            if (error)
+            {
+                auto e = std::exchange(error, nullptr);
+                std::rethrow_exception(e);
+            }
+
+            return static_cast<std::size_t>(std::count(status.begin(), status.end(), false));
+        }
+
+        std::span<value> results() noexcept
+        {
+            return values;
+        }
+
+        std::span<const value> results() const noexcept
+        {
+            return values;
+        }
+
+        bool succeeded(std::size_t index) const noexcept
+        {
+            return status[index];
+        }
+
+    private:
+        struct worker
+        {
+            buffer_input_stream<char> stream{ nullptr, nullptr };
+            lexer<buffer_input_stream<char>> lex{ stream };
+        };
+
+        void parse_range(worker& w, std::span<const std::string_view> messages, std::size_t begin, std::size_t count)
+        {
+            auto end = std::min(begin + count, messages.size());
+            for (auto i = begin; i < end; ++i)
+            {
+                w.stream = buffer_input_stream<char>(messages[i]);
+                w.lex.reset(w.stream);
+
+                auto& result = values[i];
+                auto success = parse_value(w.lex, result) && (w.lex.current_token == lexer_token::eof);
+                if (!success) result.data.emplace<std::monostate>();
+                status[i] = success;
+            }
+        }
+
+        // The loop run by each thread other than the caller's. 'index' is the thread's share of each batch
+        void run(std::size_t index)
+        {
+            std::uint64_t seen = 0;
+            std::unique_lock lock(mutex);
+            while (true)
+            {
+                start_condition.wait(lock, [&] { return stopping || (generation != seen); });
+                if (stopping) return;
+
+                seen = generation;
+                if (index >= batch_threads) continue; // The batch is too small to need this thread
+
+                lock.unlock();
+                try
+                {
+                    parse_range(*workers[index], batch, index * batch_chunk_size, batch_chunk_size);
+                }
+                catch (...)
+                {
+                    record_error();
+                }
+
+                lock.lock();
+                if (--pending == 0) done_condition.notify_one();
+            }
+        }
+
+        void record_error()
+        {
+            std::lock_guard lock(error_mutex);
+            if (!error) error = std::current_exception();
+        }
+
+        void stop() noexcept
+        {
+            {
+                std::lock_guard lock(mutex);
+                stopping = true;
+            }
+
+            start_condition.notify_all();
+            for (auto& thread : threads) thread.join();
+        }
+
+        std::vector<std::unique_ptr<worker>> workers;
+        std::vector<std::thread> threads;
+
+        // The current batch, protected by 'mutex'. Each new batch increments 'generation'
+        std::mutex mutex;
+        std::condition_variable start_condition;
+        std::condition_variable done_condition;
+        std::uint64_t generation = 0;
+        std::span<const std::string_view> batch;
+        std::size_t batch_chunk_size = 0;
+        std::size_t batch_threads = 0;
+        std::size_t pending = 0; // Threads other than the caller's that have not finished the current batch
+        bool stopping = false;
+
+        std::mutex error_mutex;
+        std::exception_ptr error; // The first exception thrown while parsing the current batch
+
+        std::vector<value> values;
+        std::vector<char> status; // NOTE: Not 'std::vector<bool>' since elements are written from multiple threads
+    };
+}
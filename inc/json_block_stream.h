@@ -0,0 +1,303 @@
+#pragma once
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <thread>
+
+#include "json_lexer.h"
+
+namespace json
+{
+    // A source of data that is read in blocks, e.g. a file or a decompressor. 'read' writes up to 'size' characters to
+    // 'buffer' and returns the number written, which may be fewer than requested. It only returns zero once all data
+    // has been read, or an error occurred, in which case 'failed' returns true
+    template <typename T>
+    concept BlockSource = requires(T source, char* buffer, std::size_t size) {
+                              {
+                                  source.read(buffer, size)
+                                  } -> std::same_as<std::size_t>;
+                              {
+                                  source.failed()
+                                  } -> std::same_as<bool>;
+                          };
+
+    // Reads from a buffer in memory. Mostly useful as the input to a decompressing source
+    struct memory_source
+    {
+        const char* data;
+        std::size_t size;
+
+        memory_source(const char* data, std::size_t size) noexcept : data(data), size(size) {}
+        memory_source(std::string_view str) noexcept : data(str.data()), size(str.size()) {}
+
+        std::size_t read(char* buffer, std::size_t count) noexcept
+        {
+            if (count > size) count = size;
+            std::memcpy(buffer, data, count);
+            data += count;
+            size -= count;
+            return count;
+        }
+
+        bool failed() const noexcept
+        {
+            return false;
+        }
+    };
+
+    // Reads from a 'std::FILE', which may be a regular file or a pipe (e.g. 'stdin' or the result of 'popen')
+    class file_source
+    {
+    public:
+        // Opens and takes ownership of the file at 'path'. If it cannot be opened, the source fails immediately
+        explicit file_source(const char* path) noexcept : owned(true)
+        {
+#ifdef _MSC_VER
+            if (fopen_s(&file, path, "rb") != 0) file = nullptr;
+#else
+            file = std::fopen(path, "rb");
+#endif
+            error = (file == nullptr);
+        }
+
+        // Reads from 'file' without taking ownership of it
+        explicit file_source(std::FILE* file) noexcept : file(file), error(file == nullptr)
+        {
+        }
+
+        ~file_source()
+        {
+            if (owned && file) std::fclose(file);
+        }
+
+        file_source(const file_source&) = delete;
+        file_source& operator=(const file_source&) = delete;
+
+        std::size_t read(char* buffer, std::size_t size) noexcept
+        {
+            if (!file) return 0;
+
+            auto count = std::fread(buffer, 1, size, file);
+            if ((count == 0) && std::ferror(file)) error = true;
+            return count;
+        }
+
+        bool failed() const noexcept
+        {
+            return error;
+        }
+
+    private:
+        std::FILE* file = nullptr;
+        bool owned = false;
+        bool error = false;
+    };
+
+    inline constexpr std::size_t default_block_size = 64 * 1024;
+
+    // An 'InputStream' that reads from a 'BlockSource' one block at a time, so that only 'BlockSize' characters are
+    // held in memory regardless of the size of the input. The source is constructed in place from the constructor
+    // arguments
+    template <BlockSource SourceT, std::size_t BlockSize = default_block_size>
+    class block_input_stream
+    {
+    public:
+        using char_type = char;
+
+        template <typename... Args>
+        explicit block_input_stream(Args&&... args) :
+            src(std::forward<Args>(args)...), buffer(std::make_unique<char[]>(BlockSize))
+        {
+        }
+
+        block_input_stream(const block_input_stream&) = delete;
+        block_input_stream& operator=(const block_input_stream&) = delete;
+
+        SourceT& source() noexcept
+        {
+            return src;
+        }
+
+        operator bool()
+        {
+            return fill();
+        }
+
+        bool eof()
+        {
+            return !fill() && !src.failed();
+        }
+
+        char get()
+        {
+            return fill() ? *read++ : invalid_char;
+        }
+
+        char peek()
+        {
+            return fill() ? *read : invalid_char;
+        }
+
+    private:
+        bool fill()
+        {
+            if (read != end) return true;
+            if (done) return false;
+
+            auto count = src.read(buffer.get(), BlockSize);
+            if (count == 0)
+            {
+                done = true;
+                return false;
+            }
+
+            read = buffer.get();
+            end = read + count;
+            return true;
+        }
+
+        SourceT src;
+        std::unique_ptr<char[]> buffer;
+        const char* read = nullptr;
+        const char* end = nullptr;
+        bool done = false;
+    };
+
+    // An 'InputStream' that reads from a 'BlockSource' on a background thread into a ring of 'BlockCount' blocks, so
+    // that reading (and e.g. decompression) overlaps with lexing. At most 'BlockCount * BlockSize' characters are held
+    // in memory regardless of the size of the input. The source is constructed in place from the constructor arguments
+    // and is only accessed by the background thread. Blocks are handed between the two threads with a lock-free single
+    // producer, single consumer ring; each side only blocks when the ring is empty or full
+    template <BlockSource SourceT, std::size_t BlockSize = default_block_size, std::size_t BlockCount = 4>
+    class async_block_input_stream
+    {
+        static_assert(BlockCount >= 2, "At least two blocks are needed for reading to overlap with lexing");
+
+    public:
+        using char_type = char;
+
+        template <typename... Args>
+        explicit async_block_input_stream(Args&&... args) : src(std::forward<Args>(args)...)
+        {
+            for (auto& block : blocks) block.data = std::make_unique<char[]>(BlockSize);
+            thread = std::thread([this] { produce(); });
+        }
+
+        // NOTE: If the producer is blocked inside of the source's 'read' (e.g. waiting on a pipe), this waits for it
+        ~async_block_input_stream()
+        {
+            stopping.store(true, std::memory_order_release);
+
+            // Change 'consumed' so that a producer waiting for a free block wakes up and observes 'stopping'
+            consumed.fetch_add(1, std::memory_order_release);
+            consumed.notify_one();
+            thread.join();
+        }
+
+        async_block_input_stream(const async_block_input_stream&) = delete;
+        async_block_input_stream& operator=(const async_block_input_stream&) = delete;
+
+        operator bool()
+        {
+            return fill();
+        }
+
+        bool eof()
+        {
+            return !fill() && !failed;
+        }
+
+        char get()
+        {
+            return fill() ? *read++ : invalid_char;
+        }
+
+        char peek()
+        {
+            return fill() ? *read : invalid_char;
+        }
+
+    private:
+        struct block
+        {
+            std::unique_ptr<char[]> data;
+            std::size_t size = 0; // Zero marks the end of the input
+            bool failed = false; // Only meaningful for the final, empty block
+        };
+
+        // Consumer side: moves to the next block once the current one has been consumed
+        bool fill()
+        {
+            if (read != end) return true;
+            if (done) return false;
+
+            if (holding)
+            {
+                // Give the block back to the producer
+                ++taken;
+                holding = false;
+                consumed.store(taken, std::memory_order_release);
+                consumed.notify_one();
+            }
+
+            produced.wait(taken, std::memory_order_acquire);
+
+            auto& current = blocks[taken % BlockCount];
+            if (current.size == 0)
+            {
+                done = true;
+                failed = current.failed;
+                return false;
+            }
+
+            holding = true;
+            read = current.data.get();
+            end = read + current.size;
+            return true;
+        }
+
+        // Producer side: runs on the background thread, filling blocks as they become free
+        void produce()
+        {
+            for (std::size_t filled = 0;; ++filled)
+            {
+                while (true)
+                {
+                    auto freed = consumed.load(std::memory_order_acquire);
+                    if (stopping.load(std::memory_order_acquire)) return;
+                    if (filled - freed < BlockCount) break;
+                    consumed.wait(freed, std::memory_order_acquire);
+                }
+
+                auto& current = blocks[filled % BlockCount];
+                current.size = src.read(current.data.get(), BlockSize);
+                current.failed = (current.size == 0) && src.failed();
+
+                produced.store(filled + 1, std::memory_order_release);
+                produced.notify_one();
+                if (current.size == 0) return;
+            }
+        }
+
+        SourceT src;
+        block blocks[BlockCount];
+
+        // Consumer state
+        const char* read = nullptr;
+        const char* end = nullptr;
+        std::size_t taken = 0; // Index of the block currently being read, or next to be read
+        bool holding = false; // True if 'read'/'end' point into a block that has not yet been given back
+        bool done = false;
+        bool failed = false;
+
+        // Shared state. A block may only be written by the producer while 'produced - consumed < BlockCount', and may
+        // only be read by the consumer while 'consumed < produced'
+        std::atomic<std::size_t> produced = 0; // Number of blocks filled by the producer, including the final block
+        std::atomic<std::size_t> consumed = 0; // Number of blocks given back by the consumer
+        std::atomic<bool> stopping = false;
+
+        std::thread thread;
+    };
+}
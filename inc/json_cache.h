@@ -0,0 +1,165 @@
+#pragma once
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "json.h"
+
+namespace json
+{
+    // A thread safe cache of parsed documents, keyed by the content of the input text. Repeated requests for the same
+    // input return the same shared, read-only value without re-parsing. E.g.
+    //
+    //      json::parse_cache cache(16 * 1024 * 1024);
+    //      if (auto doc = cache.get(text)) { ... }
+    //
+    // Entries are spread across independently locked shards to reduce contention. Each shard evicts its least recently
+    // used entries once it exceeds its share of the byte budget, which is measured with 'json::memory_usage' plus the
+    // size of the input text retained to verify hits
+    class parse_cache
+    {
+    public:
+        static constexpr std::size_t default_shard_count = 16;
+
+        explicit parse_cache(std::size_t byteBudget, std::size_t shardCount = default_shard_count) :
+            shard_count(shardCount ? shardCount : 1),
+            shard_budget(byteBudget / shard_count),
+            shards(std::make_unique<shard[]>(shard_count))
+        {
+        }
+
+        parse_cache(const parse_cache&) = delete;
+        parse_cache& operator=(const parse_cache&) = delete;
+
+        // Returns the parsed value for 'input', parsing it if it is not already in the cache. The input must consist of
+        // exactly one JSON value, optionally surrounded by whitespace. Returns null if the input is not valid JSON;
+        // such failures are not cached. Values that are larger than a shard's budget are returned, but not cached
+        std::shared_ptr<const value> get(std::string_view input)
+        {
+            auto hash = std::hash<std::string_view>{}(input);
+            auto& shard = shards[(hash >> 7) % shard_count];
+            {
+                std::lock_guard lock(shard.mutex);
+                if (auto result = shard.find(hash, input)) return result;
+            }
+
+            // Parse outside of the lock so that other requests to the same shard are not blocked
+            buffer_input_stream<char> stream(input);
+            lexer lexer(stream);
+            auto parsed = std::make_shared<value>();
+            if (!parse_value(lexer, *parsed) || (lexer.current_token != lexer_token::eof)) return nullptr;
+
+            auto bytes = sizeof(entry) + input.size() + sizeof(value) + json::memory_usage(*parsed).total();
+            if (bytes > shard_budget) return parsed;
+
+            std::lock_guard lock(shard.mutex);
+            if (auto result = shard.find(hash, input)) return result; // Another thread got there first
+
+            shard.lru.push_front(entry{ hash, bytes, std::string(input), parsed });
+            shard.index.emplace(hash, shard.lru.begin());
+            shard.bytes += bytes;
+            while (shard.bytes > shard_budget)
+            {
+                shard.erase(std::prev(shard.lru.end()));
+            }
+
+            return parsed;
+        }
+
+        // The number of cached documents
+        std::size_t size() const
+        {
+            std::size_t result = 0;
+            for (std::size_t i = 0; i < shard_count; ++i)
+            {
+                std::lock_guard lock(shards[i].mutex);
+                result += shards[i].lru.size();
+            }
+
+            return result;
+        }
+
+        // The number of bytes charged against the budget by all cached documents
+        std::size_t memory_usage() const
+        {
+            std::size_t result = 0;
+            for (std::size_t i = 0; i < shard_count; ++i)
+            {
+                std::lock_guard lock(shards[i].mutex);
+                result += shards[i].bytes;
+            }
+
+            return result;
+        }
+
+        // Removes all documents from the cache. Values that have already been handed out remain valid
+        void clear()
+        {
+            for (std::size_t i = 0; i < shard_count; ++i)
+            {
+                std::lock_guard lock(shards[i].mutex);
+                shards[i].index.clear();
+                shards[i].lru.clear();
+                shards[i].bytes = 0;
+            }
+        }
+
+    private:
+        struct entry
+        {
+            std::size_t hash;
+            std::size_t bytes;
+            std::string text; // Compared on lookup so that hash collisions can never return the wrong document
+            std::shared_ptr<const value> data;
+        };
+
+        using entry_list = std::list<entry>;
+
+        struct shard
+        {
+            std::shared_ptr<const value> find(std::size_t hash, std::string_view input)
+            {
+                auto [begin, end] = index.equal_range(hash);
+                for (auto itr = begin; itr != end; ++itr)
+                {
+                    if (itr->second->text == input)
+                    {
+                        lru.splice(lru.begin(), lru, itr->second);
+                        return itr->second->data;
+                    }
+                }
+
+                return nullptr;
+            }
+
+            void erase(entry_list::iterator pos)
+            {
+                auto [begin, end] = index.equal_range(pos->hash);
+                for (auto itr = begin; itr != end; ++itr)
+                {
+                    if (itr->second == pos)
+                    {
+                        index.erase(itr);
+                        break;
+                    }
+                }
+
+                bytes -= pos->bytes;
+                lru.erase(pos);
+            }
+
+            mutable std::mutex mutex;
+            entry_list lru; // Most recently used first
+            std::unordered_multimap<std::size_t, entry_list::iterator> index;
+            std::size_t bytes = 0;
+        };
+
+        std::size_t shard_count;
+        std::size_t shard_budget;
+        std::unique_ptr<shard[]> shards;
+    };
+}
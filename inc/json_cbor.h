@@ -0,0 +1,358 @@
+#pragma once
+
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "json.h"
+
+// Conversion between 'json::value' and CBOR (RFC 8949). Decoding a cached CBOR encoding avoids all text processing
+// (whitespace, escapes, number formatting, etc.), making it considerably faster than 'parse_value' on the equivalent
+// JSON text. E.g.
+//
+//      std::vector<std::uint8_t> bytes;
+//      if (!json::cbor_encode(value, bytes)) { ... }
+//      ...
+//      json::value reloaded;
+//      if (!json::cbor_decode(bytes, reloaded)) { ... }
+namespace json
+{
+    // The maximum nesting depth of arrays and maps accepted by 'cbor_decode'
+    inline constexpr std::size_t cbor_max_depth = 512;
+
+    namespace details
+    {
+        enum class cbor_major : std::uint8_t
+        {
+            unsigned_integer = 0,
+            negative_integer = 1,
+            byte_string = 2,
+            text_string = 3,
+            array = 4,
+            map = 5,
+            tag = 6,
+            simple = 7,
+        };
+
+        inline constexpr std::uint8_t cbor_false = 0xF4;
+        inline constexpr std::uint8_t cbor_true = 0xF5;
+        inline constexpr std::uint8_t cbor_null = 0xF6;
+        inline constexpr std::uint8_t cbor_undefined = 0xF7;
+        inline constexpr std::uint8_t cbor_float16 = 0xF9;
+        inline constexpr std::uint8_t cbor_float32 = 0xFA;
+        inline constexpr std::uint8_t cbor_float64 = 0xFB;
+
+        // Writes the initial byte(s) of an item, using the shortest encoding for 'argument'
+        inline void cbor_write_head(std::vector<std::uint8_t>& out, cbor_major major, std::uint64_t argument)
+        {
+            auto type = static_cast<std::uint8_t>(static_cast<std::uint8_t>(major) << 5);
+            int bytes;
+            if (argument < 24)
+            {
+                out.push_back(static_cast<std::uint8_t>(type | argument));
+                return;
+            }
+            else if (argument <= 0xFF)
+            {
+                out.push_back(type | 24);
+                bytes = 1;
+            }
+            else if (argument <= 0xFFFF)
+            {
+                out.push_back(type | 25);
+                bytes = 2;
+            }
+            else if (argument <= 0xFFFFFFFF)
+            {
+                out.push_back(type | 26);
+                bytes = 4;
+            }
+            else
+            {
+                out.push_back(type | 27);
+                bytes = 8;
+            }
+
+            for (int i = bytes - 1; i >= 0; --i) out.push_back(static_cast<std::uint8_t>(argument >> (i * 8)));
+        }
+
+        // Returns false if 'val' contains a number that has no CBOR equivalent
+        inline bool cbor_encode_value(const value& val, std::vector<std::uint8_t>& out)
+        {
+            if (auto str = val.get_string())
+            {
+                cbor_write_head(out, cbor_major::text_string, str->size());
+                out.insert(out.end(), str->begin(), str->end());
+            }
+            else if (auto num = val.get_number())
+            {
+                // Integers that can be represented exactly use the (much smaller) integer encodings. 64-bit integers
+                // are converted directly from their text so that they do not lose precision
+                constexpr double limit = 18446744073709551616.0; // 2^64
+                if (num->is_integral())
+                {
+                    if (auto u = num->get<std::uint64_t>())
+                    {
+                        cbor_write_head(out, cbor_major::unsigned_integer, *u);
+                        return true;
+                    }
+                    else if (auto i = num->get<std::int64_t>(); i && (*i < 0))
+                    {
+                        cbor_write_head(out, cbor_major::negative_integer, static_cast<std::uint64_t>(-(*i + 1)));
+                        return true;
+                    }
+                }
+
+                // Numbers out of range for a 'double' (e.g. '1e400') cannot be encoded without losing their value
+                auto converted = num->get<double>();
+                if (!converted || !std::isfinite(*converted)) return false;
+
+                auto d = *converted;
+                if ((d == std::trunc(d)) && (d < limit) && !std::signbit(d))
+                {
+                    cbor_write_head(out, cbor_major::unsigned_integer, static_cast<std::uint64_t>(d));
+                }
+                else if ((d == std::trunc(d)) && (d > -limit) && (d < 0))
+                {
+                    cbor_write_head(out, cbor_major::negative_integer, static_cast<std::uint64_t>(-1 - d));
+                }
+                else
+                {
+                    out.push_back(cbor_float64);
+                    auto bits = std::bit_cast<std::uint64_t>(d);
+                    for (int i = 7; i >= 0; --i) out.push_back(static_cast<std::uint8_t>(bits >> (i * 8)));
+                }
+            }
+            else if (auto arr = val.get_array())
+            {
+                cbor_write_head(out, cbor_major::array, arr->size());
+                for (auto& element : *arr)
+                {
+                    if (!cbor_encode_value(element, out)) return false;
+                }
+            }
+            else if (auto obj = val.get_object())
+            {
+                cbor_write_head(out, cbor_major::map, obj->size());
+                for (auto& pair : *obj)
+                {
+                    cbor_write_head(out, cbor_major::text_string, pair.first.size());
+                    out.insert(out.end(), pair.first.begin(), pair.first.end());
+                    if (!cbor_encode_value(pair.second, out)) return false;
+                }
+            }
+            else if (auto b = val.get_boolean())
+            {
+                out.push_back(*b ? cbor_true : cbor_false);
+            }
+            else if (val.get_null())
+            {
+                out.push_back(cbor_null);
+            }
+            else
+            {
+                out.push_back(cbor_undefined);
+            }
+
+            return true;
+        }
+
+        struct cbor_reader
+        {
+            const std::uint8_t* pos;
+            const std::uint8_t* end;
+
+            std::size_t remaining() const noexcept
+            {
+                return static_cast<std::size_t>(end - pos);
+            }
+
+            bool read_uint(int bytes, std::uint64_t& result) noexcept
+            {
+                if (remaining() < static_cast<std::size_t>(bytes)) return false;
+
+                result = 0;
+                for (int i = 0; i < bytes; ++i) result = (result << 8) | *pos++;
+                return true;
+            }
+
+            // Reads the initial byte(s) of an item. Indefinite lengths are not supported
+            bool read_head(cbor_major& major, std::uint8_t& info, std::uint64_t& argument) noexcept
+            {
+                if (pos == end) return false;
+
+                auto initial = *pos++;
+                major = static_cast<cbor_major>(initial >> 5);
+                info = initial & 0x1F;
+                if (info < 24)
+                {
+                    argument = info;
+                    return true;
+                }
+                else if (info <= 27)
+                {
+                    return read_uint(1 << (info - 24), argument);
+                }
+
+                return false;
+            }
+
+            bool read_text(std::uint64_t length, string& target)
+            {
+                if (remaining() < length) return false;
+
+                target.assign(reinterpret_cast<const char*>(pos), static_cast<std::size_t>(length));
+                pos += length;
+                return true;
+            }
+
+            bool read_value(value& target, std::size_t depth = 0)
+            {
+                if (depth >= cbor_max_depth) return false;
+
+                // Tags carry no meaning for JSON, so skip over them
+                cbor_major major;
+                std::uint8_t info;
+                std::uint64_t argument;
+                do
+                {
+                    if (!read_head(major, info, argument)) return false;
+                } while (major == cbor_major::tag);
+
+                switch (major)
+                {
+                case cbor_major::unsigned_integer: target.data.emplace<number>(argument); return true;
+
+                case cbor_major::negative_integer:
+                    if (argument <= static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max()))
+                    {
+                        target.data.emplace<number>(-1 - static_cast<std::int64_t>(argument));
+                    }
+                    else
+                    {
+                        target.data.emplace<number>(-1.0 - static_cast<double>(argument));
+                    }
+
+                    return true;
+
+                case cbor_major::text_string: return read_text(argument, target.data.emplace<string>());
+
+                case cbor_major::array: {
+                    // Each element takes at least one byte, so the count can be validated before reserving memory
+                    if (argument > remaining()) return false;
+
+                    auto& arr = target.data.emplace<array>();
+                    arr.resize(static_cast<std::size_t>(argument));
+                    for (auto& element : arr)
+                    {
+                        if (!read_value(element, depth + 1)) return false;
+                    }
+
+                    return true;
+                }
+
+                case cbor_major::map: {
+                    if (argument > remaining() / 2) return false;
+
+                    auto& obj = target.data.emplace<object>();
+                    obj.reserve(static_cast<std::size_t>(argument));
+                    string key;
+                    for (std::uint64_t i = 0; i < argument; ++i)
+                    {
+                        cbor_major keyMajor;
+                        std::uint8_t keyInfo;
+                        std::uint64_t keyLength;
+                        if (!read_head(keyMajor, keyInfo, keyLength) || (keyMajor != cbor_major::text_string))
+                            return false;
+                        if (!read_text(keyLength, key)) return false;
+
+                        auto [itr, inserted] = obj.try_emplace(std::move(key));
+                        if (!inserted || !read_value(itr->second, depth + 1)) return false;
+                    }
+
+                    return true;
+                }
+
+                case cbor_major::simple: return read_simple(info, argument, target);
+
+                default: return false; // Byte strings have no JSON equivalent
+                }
+            }
+
+            bool read_simple(std::uint8_t info, std::uint64_t argument, value& target) noexcept
+            {
+                switch (info)
+                {
+                case cbor_false & 0x1F: target.data.emplace<boolean>(false); return true;
+                case cbor_true & 0x1F: target.data.emplace<boolean>(true); return true;
+                case cbor_null & 0x1F: target.data.emplace<null>(nullptr); return true;
+                case cbor_undefined & 0x1F: target.data.emplace<std::monostate>(); return true;
+
+                case cbor_float16 & 0x1F: {
+                    auto half = static_cast<std::uint16_t>(argument);
+                    auto exponent = (half >> 10) & 0x1F;
+                    auto mantissa = half & 0x3FF;
+                    double result;
+                    if (exponent == 0) result = std::ldexp(mantissa, -24);
+                    else if (exponent != 31) result = std::ldexp(mantissa + 1024, exponent - 25);
+                    else return false; // Infinity and NaN cannot be represented in JSON
+
+                    target.data.emplace<number>((half & 0x8000) ? -result : result);
+                    return true;
+                }
+
+                case cbor_float32 & 0x1F: {
+                    auto result = std::bit_cast<float>(static_cast<std::uint32_t>(argument));
+                    if (!std::isfinite(result)) return false;
+                    target.data.emplace<number>(result);
+                    return true;
+                }
+
+                case cbor_float64 & 0x1F: {
+                    auto result = std::bit_cast<double>(argument);
+                    if (!std::isfinite(result)) return false;
+                    target.data.emplace<number>(result);
+                    return true;
+                }
+
+                default: return false;
+                }
+            }
+        };
+    }
+
+    // Appends the CBOR encoding of 'val' to 'out'. Integral numbers use CBOR's integer encodings; all other numbers are
+    // encoded as 64-bit floats. Uninitialized ('monostate') values encode as 'undefined'. Numbers that are out of
+    // range for both a 64-bit integer and a 'double' (e.g. '1e400') have no exact CBOR equivalent, so encoding fails
+    // and 'out' is left unchanged
+    inline bool cbor_encode(const value& val, std::vector<std::uint8_t>& out)
+    {
+        auto previousSize = out.size();
+        if (details::cbor_encode_value(val, out)) return true;
+
+        out.resize(previousSize);
+        return false;
+    }
+
+    inline std::optional<std::vector<std::uint8_t>> cbor_encode(const value& val)
+    {
+        std::vector<std::uint8_t> result;
+        if (!cbor_encode(val, result)) return std::nullopt;
+        return result;
+    }
+
+    // Decodes a single CBOR item that spans all of 'data'. Byte strings, indefinite lengths, non-string map keys,
+    // duplicate keys, and non-finite numbers are rejected since they have no JSON equivalent. Tags are ignored. Arrays
+    // and maps nested more than 'cbor_max_depth' levels deep are rejected, so that untrusted input cannot exhaust the
+    // stack
+    inline bool cbor_decode(std::span<const std::uint8_t> data, value& target)
+    {
+        details::cbor_reader reader{ data.data(), data.data() + data.size() };
+        return reader.read_value(target) && (reader.pos == reader.end);
+    }
+}
@@ -0,0 +1,310 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "json.h"
+
+namespace json
+{
+    enum class column_type
+    {
+        number, // 'double'
+        integer, // 'std::int64_t'; numbers that are not exact integers fail to parse
+        boolean, // 'std::uint8_t', with 0 for false and 1 for true
+        string, // Offsets into a single buffer of characters
+    };
+
+    // A single column produced by 'json::columnar_reader'. Values are stored contiguously in the buffer matching the
+    // column's type; the accessors for all other types return empty spans. Rows where the field is missing or 'null'
+    // hold a default value (zero, false, or an empty string) and are marked as invalid in the validity bitmap
+    class column
+    {
+    public:
+        column(std::string name, column_type type) : column_name(std::move(name)), data_type(type)
+        {
+        }
+
+        const std::string& name() const noexcept
+        {
+            return column_name;
+        }
+
+        column_type type() const noexcept
+        {
+            return data_type;
+        }
+
+        std::size_t size() const noexcept
+        {
+            return rows;
+        }
+
+        // True if 'row' held a non-null value
+        bool is_valid(std::size_t row) const noexcept
+        {
+            return (validity_bits[row / 64] >> (row % 64)) & 1;
+        }
+
+        // One bit per row, least significant bit first, set for rows that hold a non-null value
+        std::span<const std::uint64_t> validity() const noexcept
+        {
+            return validity_bits;
+        }
+
+        std::size_t null_count() const noexcept
+        {
+            return nulls;
+        }
+
+        std::span<const double> numbers() const noexcept
+        {
+            return number_values;
+        }
+
+        std::span<const std::int64_t> integers() const noexcept
+        {
+            return integer_values;
+        }
+
+        std::span<const std::uint8_t> booleans() const noexcept
+        {
+            return boolean_values;
+        }
+
+        // For string columns, the characters of row 'i' are those of 'string_bytes()' in the range
+        // '[string_offsets()[i], string_offsets()[i + 1])'. There is one more offset than there are rows
+        std::span<const std::size_t> string_offsets() const noexcept
+        {
+            return (data_type == column_type::string) ? std::span<const std::size_t>(offsets) :
+                                                        std::span<const std::size_t>();
+        }
+
+        std::string_view string_bytes() const noexcept
+        {
+            return bytes;
+        }
+
+        std::string_view string(std::size_t row) const noexcept
+        {
+            return std::string_view(bytes).substr(offsets[row], offsets[row + 1] - offsets[row]);
+        }
+
+    private:
+        friend class columnar_reader;
+
+        template <InputStream InputStreamT>
+        bool append(lexer<InputStreamT>& lexer)
+        {
+            if (lexer.current_token == lexer_token::keyword_null)
+            {
+                lexer.advance();
+                append_null();
+                return true;
+            }
+
+            switch (data_type)
+            {
+            case column_type::number: {
+                double value;
+                if (!parse_number(lexer, value)) return false;
+                number_values.push_back(value);
+                break;
+            }
+
+            case column_type::integer: {
+                std::int64_t value;
+                if (!parse_number(lexer, value)) return false;
+                integer_values.push_back(value);
+                break;
+            }
+
+            case column_type::boolean: {
+                bool value;
+                if (!parse_bool(lexer, value)) return false;
+                boolean_values.push_back(value);
+                break;
+            }
+
+            case column_type::string:
+                if (lexer.current_token != lexer_token::string) return false;
+                bytes.append(lexer.string_value);
+                offsets.push_back(bytes.size());
+                lexer.advance();
+                break;
+            }
+
+            append_validity(true);
+            return true;
+        }
+
+        void append_null()
+        {
+            switch (data_type)
+            {
+            case column_type::number: number_values.push_back(0); break;
+            case column_type::integer: integer_values.push_back(0); break;
+            case column_type::boolean: boolean_values.push_back(0); break;
+            case column_type::string: offsets.push_back(bytes.size()); break;
+            }
+
+            append_validity(false);
+            ++nulls;
+        }
+
+        void append_validity(bool valid)
+        {
+            if (rows % 64 == 0) validity_bits.push_back(0);
+            if (valid) validity_bits.back() |= std::uint64_t(1) << (rows % 64);
+            ++rows;
+        }
+
+        // Removes all rows after the first 'count'
+        void truncate(std::size_t count)
+        {
+            for (auto row = count; row < rows; ++row)
+            {
+                if (!is_valid(row)) --nulls;
+            }
+
+            rows = count;
+            validity_bits.resize((count + 63) / 64);
+            if (count % 64) validity_bits.back() &= (std::uint64_t(1) << (count % 64)) - 1;
+
+            number_values.resize(std::min(number_values.size(), count));
+            integer_values.resize(std::min(integer_values.size(), count));
+            boolean_values.resize(std::min(boolean_values.size(), count));
+            if (data_type == column_type::string)
+            {
+                offsets.resize(count + 1);
+                bytes.resize(offsets.back());
+            }
+        }
+
+        std::string column_name;
+        column_type data_type;
+        std::size_t rows = 0;
+        std::size_t nulls = 0;
+        std::vector<std::uint64_t> validity_bits;
+        std::vector<double> number_values;
+        std::vector<std::int64_t> integer_values;
+        std::vector<std::uint8_t> boolean_values;
+        std::vector<std::size_t> offsets = { 0 };
+        std::string bytes;
+    };
+
+    // Extracts fields from an array of objects directly into per-column buffers, without building a 'json::value' for
+    // each object. E.g.
+    //
+    //      json::columnar_reader reader;
+    //      auto ts = reader.add_column("ts", json::column_type::integer);
+    //      auto v = reader.add_column("v", json::column_type::number);
+    //      if (!reader.read(lexer)) { ... }
+    //      auto values = reader[v].numbers();
+    //
+    // Fields that are not columns are skipped. Each call to 'read' appends the rows of one array to the columns
+    class columnar_reader
+    {
+    public:
+        static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+        // Adds a column for the field 'name', returning its index. If rows have already been read, the new column is
+        // null for all of them. This invalidates references to existing columns. If there is already a column for
+        // 'name', its index is returned instead, or 'npos' if that column has a different type
+        std::size_t add_column(std::string name, column_type type)
+        {
+            auto itr = indices.find(name);
+            if (itr != indices.end()) return (columns[itr->second].type() == type) ? itr->second : npos;
+
+            auto index = columns.size();
+            auto& col = columns.emplace_back(name, type);
+            for (std::size_t i = 0; i < rows; ++i) col.append_null();
+            indices.emplace(std::move(name), index);
+            seen.push_back(false);
+            return index;
+        }
+
+        std::size_t column_count() const noexcept
+        {
+            return columns.size();
+        }
+
+        const column& operator[](std::size_t index) const noexcept
+        {
+            return columns[index];
+        }
+
+        const column* find(std::string_view name) const noexcept
+        {
+            auto itr = indices.find(name);
+            return (itr == indices.end()) ? nullptr : &columns[itr->second];
+        }
+
+        std::size_t row_count() const noexcept
+        {
+            return rows;
+        }
+
+        // Parses an array of objects, appending one row to every column for each object. Fails if an element is not
+        // an object, a field has the wrong type for its column, or an object has the same field more than once. On
+        // failure, no rows from the array are kept
+        template <InputStream InputStreamT>
+        bool read(lexer<InputStreamT>& lexer)
+        {
+            auto previousRows = rows;
+            auto success = parse_array(lexer, *this, [](auto& lexer, columnar_reader& self) {
+                return self.read_row(lexer);
+            });
+
+            if (!success)
+            {
+                rows = previousRows;
+                for (auto& col : columns) col.truncate(rows);
+            }
+
+            return success;
+        }
+
+        // Removes all rows, keeping the columns
+        void clear()
+        {
+            rows = 0;
+            for (auto& col : columns) col.truncate(0);
+        }
+
+    private:
+        template <InputStream InputStreamT>
+        bool read_row(lexer<InputStreamT>& lexer)
+        {
+            std::fill(seen.begin(), seen.end(), false);
+            auto success = parse_object(lexer, *this, [](auto& lexer, columnar_reader& self, auto& name) {
+                auto itr = self.indices.find(name);
+                if (itr == self.indices.end()) return ignore_value(lexer);
+
+                if (self.seen[itr->second]) return false;
+                self.seen[itr->second] = true;
+                return self.columns[itr->second].append(lexer);
+            });
+
+            // Keep every column the same length, even on failure, so that 'truncate' applies evenly
+            for (std::size_t i = 0; i < columns.size(); ++i)
+            {
+                if (!seen[i]) columns[i].append_null();
+            }
+
+            ++rows;
+            return success;
+        }
+
+        std::vector<column> columns;
+        std::unordered_map<std::string, std::size_t, details::string_hash, std::equal_to<>> indices;
+        std::vector<char> seen;
+        std::size_t rows = 0;
+    };
+}
@@ -0,0 +1,453 @@
+#pragma once
+
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "json.h"
+
+namespace json
+{
+    template <InputStream InputStreamT>
+    class document_cursor;
+
+    // A lightweight, forward-only reference to a value in a document being read by a 'document_cursor'. Accessing a
+    // value consumes it along with any values before it that have not yet been visited, so values must be accessed in
+    // the order that they appear in the document. Once the document has moved past a value, any cursor referencing it
+    // (or any of its children) becomes invalid and all operations on it fail
+    template <InputStream InputStreamT>
+    class value_cursor
+    {
+    public:
+        using char_type = typename InputStreamT::char_type;
+        using string_view_type = std::basic_string_view<char_type>;
+
+        struct member
+        {
+            string_view_type key; // NOTE: Only valid until the next member name is read
+            value_cursor value;
+        };
+
+        class element_iterator;
+        class member_iterator;
+
+        struct member_range
+        {
+            value_cursor cursor;
+
+            member_iterator begin() const
+            {
+                return member_iterator(cursor);
+            }
+
+            std::default_sentinel_t end() const noexcept
+            {
+                return {};
+            }
+        };
+
+        value_cursor() = default;
+
+        // False if this cursor refers to a value that does not exist, e.g. the result of looking up a missing member
+        explicit operator bool() const noexcept
+        {
+            return doc != nullptr;
+        }
+
+        // The token that begins this value, or 'invalid' if the value is no longer available
+        lexer_token type() const noexcept
+        {
+            return (doc && doc->at(depth, position)) ? doc->lex.current_token : lexer_token::invalid;
+        }
+
+        // Finds the member with the given name, skipping all members before it. This value must be an object. If the
+        // member is the one that the document is currently at (e.g. 'doc["user"]' after 'doc["user"]["id"]'), the same
+        // value is returned
+        value_cursor operator[](string_view_type name) const
+        {
+            if (!doc || !doc->enter(depth, position, lexer_token::curly_open)) return {};
+
+            auto& level = doc->levels[depth];
+            if ((level.count > 0) && (doc->keys[depth] == name)) return value_cursor(doc, depth + 1, level.current);
+
+            while (doc->next(depth))
+            {
+                if (doc->keys[depth] == name) return value_cursor(doc, depth + 1, doc->position);
+            }
+
+            return {};
+        }
+
+        // Finds the element at the given index, skipping all elements before it. This value must be an array
+        value_cursor operator[](std::size_t index) const
+        {
+            if (!doc || !doc->enter(depth, position, lexer_token::bracket_open)) return {};
+
+            auto& level = doc->levels[depth];
+            if (level.count == index + 1) return value_cursor(doc, depth + 1, level.current);
+
+            while (doc->next(depth))
+            {
+                if (doc->levels[depth].count == index + 1) return value_cursor(doc, depth + 1, doc->position);
+            }
+
+            return {};
+        }
+
+        // Reads and consumes the value. Strings can be read as a 'string_view_type', which borrows from a buffer owned
+        // by the document and is only valid until the next string value is read. Reading as a 'json::value' parses the
+        // whole value. On a type mismatch, 'std::nullopt' is returned and the value is not consumed
+        template <typename T>
+        std::optional<T> get() const
+        {
+            if (!doc || !doc->at(depth, position)) return std::nullopt;
+
+            auto& lexer = doc->lex;
+            T result{};
+            bool success;
+            if constexpr (std::is_same_v<T, string_view_type>)
+            {
+                success = (lexer.current_token == lexer_token::string);
+                if (success)
+                {
+                    doc->string.swap(lexer.string_value);
+                    lexer.advance();
+                    result = doc->string;
+                }
+            }
+            else if constexpr (std::is_same_v<T, value>)
+            {
+                // NOTE: A partially consumed value leaves the document in an unknown state
+                success = parse_value(lexer, result);
+                if (!success) doc->failed = true;
+            }
+            else if constexpr (std::is_same_v<T, bool>) success = parse_bool(lexer, result);
+            else if constexpr (std::is_same_v<T, std::nullptr_t>) success = parse_null(lexer, result);
+            else if constexpr (Number<T>) success = parse_number(lexer, result);
+            else success = parse_string(lexer, result);
+
+            if (!success) return std::nullopt;
+
+            doc->at_value = false;
+            return result;
+        }
+
+        // Range-for over the elements of an array
+        element_iterator begin() const
+        {
+            return element_iterator(*this);
+        }
+
+        std::default_sentinel_t end() const noexcept
+        {
+            return {};
+        }
+
+        // Range-for over the members of an object
+        member_range members() const noexcept
+        {
+            return member_range{ *this };
+        }
+
+        class element_iterator
+        {
+        public:
+            using difference_type = std::ptrdiff_t;
+            using value_type = value_cursor;
+
+            element_iterator() = default;
+
+            value_cursor operator*() const noexcept
+            {
+                return current;
+            }
+
+            element_iterator& operator++()
+            {
+                auto doc = current.doc;
+                current =
+                    doc->next(current.depth - 1) ? value_cursor(doc, current.depth, doc->position) : value_cursor();
+                return *this;
+            }
+
+            void operator++(int)
+            {
+                ++*this;
+            }
+
+            bool operator==(std::default_sentinel_t) const noexcept
+            {
+                return !current;
+            }
+
+        private:
+            friend class value_cursor;
+
+            explicit element_iterator(const value_cursor& array)
+            {
+                if (array.doc && array.doc->enter(array.depth, array.position, lexer_token::bracket_open))
+                {
+                    current = value_cursor(array.doc, array.depth + 1, 0);
+                    ++*this;
+                }
+            }
+
+            value_cursor current;
+        };
+
+        class member_iterator
+        {
+        public:
+            using difference_type = std::ptrdiff_t;
+            using value_type = member;
+
+            member_iterator() = default;
+
+            member operator*() const noexcept
+            {
+                return member{ current.doc->keys[current.depth - 1], current };
+            }
+
+            member_iterator& operator++()
+            {
+                auto doc = current.doc;
+                current =
+                    doc->next(current.depth - 1) ? value_cursor(doc, current.depth, doc->position) : value_cursor();
+                return *this;
+            }
+
+            void operator++(int)
+            {
+                ++*this;
+            }
+
+            bool operator==(std::default_sentinel_t) const noexcept
+            {
+                return !current;
+            }
+
+        private:
+            friend class value_cursor;
+            friend struct member_range;
+
+            explicit member_iterator(const value_cursor& object)
+            {
+                if (object.doc && object.doc->enter(object.depth, object.position, lexer_token::curly_open))
+                {
+                    current = value_cursor(object.doc, object.depth + 1, 0);
+                    ++*this;
+                }
+            }
+
+            value_cursor current;
+        };
+
+    private:
+        friend class document_cursor<InputStreamT>;
+
+        value_cursor(document_cursor<InputStreamT>* doc, std::size_t depth, std::size_t position) noexcept :
+            doc(doc), depth(depth), position(position)
+        {
+        }
+
+        document_cursor<InputStreamT>* doc = nullptr;
+        std::size_t depth = 0; // Number of containers enclosing this value
+        std::size_t position = 0; // Identifies this value within the document
+    };
+
+    // On-demand access to a document, lazily driving a 'json::lexer' as values are requested. This gives DOM-like
+    // access without building a DOM; anything that is not accessed is skipped. E.g.
+    //
+    //      json::document_cursor doc(lexer);
+    //      auto id = doc["user"]["id"].get<std::int64_t>();
+    //      for (auto tag : doc["tags"]) { ... }
+    //
+    // The document must outlive all cursors that reference it. It is neither copyable nor movable for this reason
+    template <InputStream InputStreamT>
+    class document_cursor
+    {
+    public:
+        using char_type = typename InputStreamT::char_type;
+        using string_view_type = std::basic_string_view<char_type>;
+
+        document_cursor(lexer<InputStreamT>& lexer) : lex(lexer)
+        {
+        }
+
+        document_cursor(const document_cursor&) = delete;
+        document_cursor& operator=(const document_cursor&) = delete;
+
+        // False if the input was found to be malformed
+        explicit operator bool() const noexcept
+        {
+            return !failed && (lex.current_token != lexer_token::invalid);
+        }
+
+        value_cursor<InputStreamT> root() noexcept
+        {
+            return value_cursor<InputStreamT>(this, 0, 0);
+        }
+
+        value_cursor<InputStreamT> operator[](string_view_type name)
+        {
+            return root()[name];
+        }
+
+        value_cursor<InputStreamT> operator[](std::size_t index)
+        {
+            return root()[index];
+        }
+
+        template <typename T>
+        std::optional<T> get()
+        {
+            return root().template get<T>();
+        }
+
+        auto begin()
+        {
+            return root().begin();
+        }
+
+        std::default_sentinel_t end() const noexcept
+        {
+            return {};
+        }
+
+        auto members()
+        {
+            return root().members();
+        }
+
+        // Consumes the remainder of the document, leaving the lexer at the token following the root value
+        bool finish()
+        {
+            if (!close_until(0)) return false;
+            if (at_value && levels.empty())
+            {
+                if (!ignore_value(lex)) return fail();
+                at_value = false;
+            }
+
+            return !failed;
+        }
+
+    private:
+        friend class value_cursor<InputStreamT>;
+
+        struct level
+        {
+            lexer_token open; // Either 'curly_open' or 'bracket_open'
+            std::size_t position; // Position of the container value
+            std::size_t count; // Number of members/elements that have been reached
+            std::size_t current; // Position of the most recently reached member/element
+        };
+
+        // True if the lexer is at the start of the value identified by 'depth' and 'pos'
+        bool at(std::size_t depth, std::size_t pos) const noexcept
+        {
+            return !failed && at_value && (levels.size() == depth) && (position == pos);
+        }
+
+        bool fail() noexcept
+        {
+            failed = true;
+            return false;
+        }
+
+        // Enters the container identified by 'depth' and 'pos' if the lexer is at its start, or verifies that it is
+        // the container that was previously entered at that depth
+        bool enter(std::size_t depth, std::size_t pos, lexer_token open)
+        {
+            if (failed) return false;
+
+            if (levels.size() > depth)
+            {
+                return (levels[depth].position == pos) && (levels[depth].open == open);
+            }
+
+            if (!at(depth, pos) || (lex.current_token != open)) return false;
+
+            lex.advance();
+            levels.push_back(level{ open, pos, 0, 0 });
+            if (keys.size() < levels.size()) keys.resize(levels.size());
+            at_value = false;
+            return true;
+        }
+
+        bool close_until(std::size_t size)
+        {
+            while (levels.size() > size)
+            {
+                while (next_innermost())
+                {
+                }
+
+                if (failed) return false;
+            }
+
+            return true;
+        }
+
+        // Moves to the next member/element of the container at 'depth', skipping any unconsumed values. Returns false
+        // once the container has been closed
+        bool next(std::size_t depth)
+        {
+            if (failed || (levels.size() <= depth)) return false;
+            if (!close_until(depth + 1)) return false;
+            return next_innermost();
+        }
+
+        bool next_innermost()
+        {
+            if (at_value)
+            {
+                if (!ignore_value(lex)) return fail();
+                at_value = false;
+            }
+
+            auto& current = levels.back();
+            auto isObject = (current.open == lexer_token::curly_open);
+            if (lex.current_token == (isObject ? lexer_token::curly_close : lexer_token::bracket_close))
+            {
+                lex.advance();
+                levels.pop_back();
+                return false;
+            }
+
+            if (current.count > 0)
+            {
+                if (lex.current_token != lexer_token::comma) return fail();
+                lex.advance();
+            }
+
+            if (isObject)
+            {
+                // NOTE: Swapping buffers for the same reason as 'parse_object'
+                if (lex.current_token != lexer_token::string) return fail();
+                keys[levels.size() - 1].swap(lex.string_value);
+                lex.advance();
+
+                if (lex.current_token != lexer_token::colon) return fail();
+                lex.advance();
+            }
+
+            if (!details::valid_callback_token(lex.current_token)) return fail();
+
+            ++current.count;
+            current.current = ++position;
+            at_value = true;
+            return true;
+        }
+
+        lexer<InputStreamT>& lex;
+        std::vector<level> levels; // Containers that have been entered, but not yet closed
+        std::size_t position = 0; // Incremented each time the lexer reaches a new member/element
+        bool at_value = true; // True when the lexer is at the start of a value that has not been consumed
+        bool failed = false;
+        std::vector<std::basic_string<char_type>> keys; // Name of the current member, indexed by depth. Never shrinks
+        std::basic_string<char_type> string;
+    };
+}
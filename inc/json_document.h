@@ -0,0 +1,386 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "json.h"
+
+namespace json
+{
+    // A parsed document that many threads read while another thread occasionally replaces it, e.g. configuration that
+    // is reloaded when its file changes. E.g.
+    //
+    //      json::shared_document config;
+    //      config.reload(text); // Background thread
+    //      ...
+    //      auto snapshot = config.load(); // Any thread
+    //      if (auto obj = snapshot->get_object()) { ... }
+    //
+    // Readers get a reference to an immutable version, which stays valid for as long as they hold it, regardless of
+    // how many times the document is replaced in the meantime. Old versions are destroyed by whichever thread releases
+    // the last reference to them.
+    //
+    // Reads never take a lock and never wait for parsing, which happens before the new version is published, and
+    // publishing swaps a single pointer. Reclamation of the published pointer is RCU-style: readers register with the
+    // current epoch for the few instructions it takes to copy the pointer, and a publisher retires the previous
+    // pointer once all readers registered with the previous epoch are done. Reads are lock-free but not wait-free: a
+    // read that races with a publish registers again, and concurrent reads all update the same counter
+    class shared_document
+    {
+    public:
+        shared_document() : shared_document(value())
+        {
+        }
+
+        explicit shared_document(value initial) :
+            current(new std::shared_ptr<const value>(std::make_shared<const value>(std::move(initial))))
+        {
+        }
+
+        ~shared_document()
+        {
+            delete current.load();
+        }
+
+        shared_document(const shared_document&) = delete;
+        shared_document& operator=(const shared_document&) = delete;
+
+        // The current version of the document. Never null
+        std::shared_ptr<const value> load() const noexcept
+        {
+            // Register with the current epoch. If a publisher advances the epoch between reading it and registering,
+            // it may not see this registration, so try again
+            std::uint64_t epoch;
+            while (true)
+            {
+                epoch = epochs.load();
+                readers[epoch % 2].count.fetch_add(1);
+                if (epochs.load() == epoch) break;
+                readers[epoch % 2].count.fetch_sub(1);
+            }
+
+            auto result = *current.load();
+            readers[epoch % 2].count.fetch_sub(1);
+            return result;
+        }
+
+        // The number of times the document has been replaced. Readers can compare this against a previously observed
+        // value to cheaply detect a change
+        std::uint64_t version() const noexcept
+        {
+            return epochs.load();
+        }
+
+        // Replaces the document. Readers that already hold the previous version are unaffected
+        void publish(std::shared_ptr<const value> newValue)
+        {
+            if (!newValue) return;
+
+            std::lock_guard lock(publish_mutex);
+            auto previous = current.exchange(new std::shared_ptr<const value>(std::move(newValue)));
+
+            // Readers that loaded 'previous' registered with the current epoch before doing so. New readers register
+            // with the next epoch, so once this one drains, nothing can still be reading 'previous'
+            auto epoch = epochs.fetch_add(1);
+            while (readers[epoch % 2].count.load() != 0) std::this_thread::yield();
+
+            delete previous;
+        }
+
+        void publish(value newValue)
+        {
+            publish(std::make_shared<const value>(std::move(newValue)));
+        }
+
+        // Parses a new version of the document from 'lexer' and publishes it. The input must consist of exactly one
+        // JSON value. If parsing fails, the current version is kept and false is returned
+        template <InputStream InputStreamT>
+        bool reload(lexer<InputStreamT>& lexer)
+        {
+            auto parsed = std::make_shared<value>();
+            if (!parse_value(lexer, *parsed) || (lexer.current_token != lexer_token::eof)) return false;
+
+            publish(std::move(parsed));
+            return true;
+        }
+
+        bool reload(std::string_view text)
+        {
+            buffer_input_stream<char> stream(text);
+            lexer lexer(stream);
+            return reload(lexer);
+        }
+
+    private:
+        // NOTE: All atomic operations are sequentially consistent. The argument above relies on a single total order
+        // of the registration, the read of 'current', the exchange, and the epoch increment
+        std::atomic<std::shared_ptr<const value>*> current;
+        std::atomic<std::uint64_t> epochs = 0;
+
+        // Every read writes to one of these, so each is on its own cache line to keep those writes from invalidating
+        // 'current', 'epochs', or the other counter in the caches of other readers. NOTE: 64 rather than
+        // 'std::hardware_destructive_interference_size', whose value may change between compiler versions and flags
+        struct alignas(64) reader_count
+        {
+            std::atomic<std::size_t> count = 0;
+        };
+        mutable reader_count readers[2];
+        std::mutex publish_mutex; // Serializes publishers, so that only one epoch is ever draining
+    };
+
+    // A range of characters, '[begin, end)'
+    struct text_span
+    {
+        std::size_t begin = 0;
+        std::size_t end = 0;
+
+        std::size_t size() const noexcept
+        {
+            return end - begin;
+        }
+    };
+
+    namespace details
+    {
+        // The position of a value in the text of an 'incremental_document'. Offsets are relative to the start of the
+        // parent value, so an edit only shifts the siblings that follow it in each enclosing value, rather than every
+        // value in the remainder of the document
+        struct span_node
+        {
+            std::size_t offset = 0;
+            std::size_t length = 0;
+            value* target = nullptr;
+            std::vector<span_node> children; // In order of offset
+        };
+
+        // Parses a value, recording its span and the spans of all nested values in 'node'. The caller sets 'target'
+        template <ContiguousInputStream InputStreamT>
+        inline bool parse_spans(lexer<InputStreamT>& lexer, value& target, span_node& node, const char* parentBegin)
+        {
+            auto begin = lexer.token_begin;
+            bool success;
+            if (lexer.current_token == lexer_token::curly_open)
+            {
+                success = parse_object(lexer, target.data.emplace<object>(), [&](auto& lexer, object& obj, auto& name) {
+                    auto [itr, inserted] = obj.try_emplace(name);
+                    if (!inserted) return false;
+
+                    auto& child = node.children.emplace_back();
+                    child.target = &itr->second;
+                    return parse_spans(lexer, itr->second, child, begin);
+                });
+            }
+            else if (lexer.current_token == lexer_token::bracket_open)
+            {
+                // Growing a vector may copy its elements, invalidating the spans of nested values, so the elements
+                // are collected first and moved into the array once it is complete
+                std::deque<value> elements;
+                success = parse_array(lexer, elements, [&](auto& lexer, std::deque<value>& elements) {
+                    return parse_spans(lexer, elements.emplace_back(), node.children.emplace_back(), begin);
+                });
+
+                auto& arr = target.data.emplace<array>(
+                    std::make_move_iterator(elements.begin()), std::make_move_iterator(elements.end()));
+                for (std::size_t i = 0; i < node.children.size(); ++i) node.children[i].target = &arr[i];
+            }
+            else
+            {
+                success = parse_value(lexer, target);
+            }
+
+            if (!success) return false;
+
+            // The lexer has already moved on to the next token, so the value ends before the whitespace preceding it
+            auto end = lexer.token_begin;
+            while ((end != begin) && is_whitespace(end[-1])) --end;
+
+            node.offset = static_cast<std::size_t>(begin - parentBegin);
+            node.length = static_cast<std::size_t>(end - begin);
+            return true;
+        }
+    }
+
+    // A document that is edited in place, e.g. by a text editor, and that must be kept parsed after each edit. Every
+    // value records its span in the text, so an edit only reparses the innermost value that encloses it. E.g.
+    //
+    //      json::incremental_document doc(text);
+    //      doc.replace(offset, 3, "true"); // Reparses only the value at 'offset', if it is the only one affected
+    //      auto& root = doc.root();
+    //
+    // If the reparsed text is no longer a single value (e.g. a comma was inserted), the next enclosing value is
+    // reparsed instead, and so on up to the whole document. The cost of an edit is therefore proportional to the size
+    // of the smallest value that remains valid on its own, plus the number of values following it in each enclosing
+    // array or object, whose offsets are shifted
+    class incremental_document
+    {
+    public:
+        explicit incremental_document(std::string text) : content(std::move(text))
+        {
+            reparse_all();
+        }
+
+        // Values in the tree refer to each other by address
+        incremental_document(const incremental_document&) = delete;
+        incremental_document& operator=(const incremental_document&) = delete;
+
+        // False if the text is not a single JSON value, in which case 'root' is uninitialized. Subsequent edits reparse
+        // the whole document until it becomes valid again
+        bool valid() const noexcept
+        {
+            return is_valid;
+        }
+
+        const std::string& text() const noexcept
+        {
+            return content;
+        }
+
+        const value& root() const noexcept
+        {
+            return root_value;
+        }
+
+        // The range of text that was parsed by the most recent edit, for diagnostic purposes
+        text_span last_reparsed() const noexcept
+        {
+            return reparsed;
+        }
+
+        // Returns the innermost value whose span contains 'position', setting 'span' (if non-null) to that span.
+        // Returns null if the document is invalid or 'position' lies outside of the root value
+        const value* find(std::size_t position, text_span* span = nullptr) const noexcept
+        {
+            if (!is_valid || (position < root_node.offset) || (position - root_node.offset >= root_node.length))
+                return nullptr;
+
+            auto node = &root_node;
+            auto begin = root_node.offset;
+            while (auto child = find_child(*node, begin, position, position + 1))
+            {
+                begin += child->offset;
+                node = child;
+            }
+
+            if (span) *span = { begin, begin + node->length };
+            return node->target;
+        }
+
+        // Replaces the 'length' characters at 'position' with 'replacement' and updates the parsed values to match.
+        // Returns true if the edited text is valid JSON, or false if it is not (see 'valid'). Ranges outside of the
+        // text are rejected without making any changes
+        bool replace(std::size_t position, std::size_t length, std::string_view replacement)
+        {
+            if ((position > content.size()) || (length > content.size() - position)) return false;
+
+            content.replace(position, length, replacement);
+            if (!is_valid) return reparse_all();
+
+            // Find the chain of values enclosing the edit, from the root inwards
+            auto editEnd = position + length;
+            if ((position < root_node.offset) || (editEnd > root_node.offset + root_node.length)) return reparse_all();
+
+            path.clear();
+            path.push_back({ &root_node, root_node.offset });
+            while (auto child = find_child(*path.back().node, path.back().begin, position, editEnd))
+            {
+                path.push_back({ child, path.back().begin + child->offset });
+            }
+
+            // NOTE: Unsigned arithmetic wraps, so adding 'delta' also works when the text got shorter
+            auto delta = replacement.size() - length;
+            for (auto i = path.size() - 1; i > 0; --i)
+            {
+                if (!reparse(*path[i].node, path[i].begin, path[i].node->length + delta)) continue;
+
+                for (auto j = i; j > 0; --j)
+                {
+                    auto parent = path[j - 1].node;
+                    parent->length += delta;
+                    for (auto sibling = path[j].node + 1; sibling != parent->children.data() + parent->children.size();
+                         ++sibling)
+                    {
+                        sibling->offset += delta;
+                    }
+                }
+
+                return true;
+            }
+
+            return reparse_all();
+        }
+
+    private:
+        struct path_entry
+        {
+            details::span_node* node;
+            std::size_t begin; // Absolute offset of 'node'
+        };
+
+        // Returns the child of 'node' (which starts at 'begin') whose span contains '[first, last)'. Insertions at
+        // either end of a span count as being contained by it, so that e.g. appending a digit only reparses the number
+        template <typename NodeT>
+        static NodeT* find_child(NodeT& node, std::size_t begin, std::size_t first, std::size_t last) noexcept
+        {
+            auto itr = std::upper_bound(node.children.begin(), node.children.end(), first - begin,
+                [](std::size_t offset, const details::span_node& child) { return offset < child.offset; });
+            if (itr == node.children.begin()) return nullptr;
+
+            --itr;
+            return (last - begin <= itr->offset + itr->length) ? &*itr : nullptr;
+        }
+
+        // Parses '[begin, begin + length)' as a single value, replacing 'node' and its value on success. On failure,
+        // nothing is modified
+        bool reparse(details::span_node& node, std::size_t begin, std::size_t length)
+        {
+            auto text = std::string_view(content).substr(begin, length);
+            buffer_input_stream<char> stream(text);
+            lexer lexer(stream);
+
+            value newValue;
+            details::span_node newNode;
+            if (!details::parse_spans(lexer, newValue, newNode, text.data()) ||
+                (lexer.current_token != lexer_token::eof))
+                return false;
+
+            // Any whitespace at the start of the text now precedes the value
+            node.offset += newNode.offset;
+            node.length = newNode.length;
+            node.children = std::move(newNode.children);
+            *node.target = std::move(newValue); // Moving containers does not move their elements
+            reparsed = { begin + newNode.offset, begin + newNode.offset + newNode.length };
+            return true;
+        }
+
+        bool reparse_all()
+        {
+            root_node = {};
+            root_node.target = &root_value;
+            is_valid = reparse(root_node, 0, content.size());
+            if (!is_valid)
+            {
+                root_node = {};
+                root_value = value();
+                reparsed = { 0, content.size() };
+            }
+
+            return is_valid;
+        }
+
+        std::string content;
+        value root_value;
+        details::span_node root_node;
+        bool is_valid = false;
+        text_span reparsed;
+        std::vector<path_entry> path; // Kept to avoid reallocating for each edit
+    };
+}
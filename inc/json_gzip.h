@@ -0,0 +1,87 @@
+#pragma once
+
+#include <zlib.h>
+
+#include "json_block_stream.h"
+
+namespace json
+{
+    // A 'BlockSource' that incrementally decompresses gzip (or zlib) data read from another 'BlockSource'. Only
+    // 'InputBlockSize' compressed bytes are buffered at a time. Concatenated gzip members are decompressed as a single
+    // stream. E.g. to overlap decompression with lexing:
+    //
+    //      json::async_block_input_stream<json::gzip_source<json::memory_source>> stream(data, size);
+    //      json::lexer lexer(stream);
+    //
+    // Using this type requires linking against zlib
+    template <BlockSource SourceT, std::size_t InputBlockSize = default_block_size>
+    class gzip_source
+    {
+    public:
+        template <typename... Args>
+        explicit gzip_source(Args&&... args) :
+            src(std::forward<Args>(args)...), input(std::make_unique<char[]>(InputBlockSize))
+        {
+            // 32 enables automatic detection of gzip vs. zlib headers
+            error = (inflateInit2(&stream, MAX_WBITS + 32) != Z_OK);
+        }
+
+        ~gzip_source()
+        {
+            inflateEnd(&stream);
+        }
+
+        gzip_source(const gzip_source&) = delete;
+        gzip_source& operator=(const gzip_source&) = delete;
+
+        std::size_t read(char* buffer, std::size_t size)
+        {
+            stream.next_out = reinterpret_cast<Bytef*>(buffer);
+            stream.avail_out = static_cast<uInt>(size);
+            while (!error && !done && (stream.avail_out > 0))
+            {
+                if ((stream.avail_in == 0) && !refill())
+                {
+                    // Input ended mid-stream
+                    error = !between_members;
+                    done = true;
+                    break;
+                }
+
+                if (between_members)
+                {
+                    if (inflateReset(&stream) != Z_OK) error = true;
+                    between_members = false;
+                    continue;
+                }
+
+                auto result = inflate(&stream, Z_NO_FLUSH);
+                if (result == Z_STREAM_END) between_members = true;
+                else if ((result != Z_OK) && (result != Z_BUF_ERROR)) error = true;
+            }
+
+            return size - stream.avail_out;
+        }
+
+        bool failed() const noexcept
+        {
+            return error || src.failed();
+        }
+
+    private:
+        bool refill()
+        {
+            auto count = src.read(input.get(), InputBlockSize);
+            stream.next_in = reinterpret_cast<Bytef*>(input.get());
+            stream.avail_in = static_cast<uInt>(count);
+            return count != 0;
+        }
+
+        SourceT src;
+        std::unique_ptr<char[]> input;
+        z_stream stream{};
+        bool between_members = false; // True after the end of a gzip member, before any further input has been seen
+        bool done = false;
+        bool error = false;
+    };
+}
@@ -1,7 +1,14 @@
 #pragma once
 
+#include <array>
+#include <bit>
 #include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
 #include <istream>
+#include <memory>
+#include <optional>
 #include <string_view>
 
 namespace json
@@ -94,6 +101,60 @@ namespace json
         return is_digit(ch) || details::in_range(ch, 'a', 'f') || details::in_range(ch, 'A', 'F');
     }
 
+    namespace details
+    {
+        // Value of each hex digit, or -1 for all other characters
+        constexpr auto hex_digit_values = []() {
+            std::array<std::int8_t, 256> result = {};
+            for (std::size_t i = 0; i < result.size(); ++i)
+            {
+                auto ch = static_cast<char32_t>(i);
+                result[i] = is_digit(ch)    ? static_cast<std::int8_t>(ch - '0') :
+                    in_range(ch, 'a', 'f') ? static_cast<std::int8_t>(10 + (ch - 'a')) :
+                    in_range(ch, 'A', 'F') ? static_cast<std::int8_t>(10 + (ch - 'A')) :
+                                             std::int8_t{ -1 };
+            }
+            return result;
+        }();
+
+        // Decodes the four hex digits of a '\u' escape all at once. Returns -1 if any is not a hex digit
+        template <Utf8Char CharT>
+        constexpr std::int32_t decode_hex_quad(const CharT* digits) noexcept
+        {
+            std::int32_t values[] = { hex_digit_values[static_cast<unsigned char>(digits[0])],
+                hex_digit_values[static_cast<unsigned char>(digits[1])],
+                hex_digit_values[static_cast<unsigned char>(digits[2])],
+                hex_digit_values[static_cast<unsigned char>(digits[3])] };
+            if ((values[0] | values[1] | values[2] | values[3]) < 0) return -1;
+            return (values[0] << 12) | (values[1] << 8) | (values[2] << 4) | values[3];
+        }
+
+        // The character that each single-character escape sequence (e.g. the 'n' in '\n') represents, or zero for
+        // characters that are not valid escapes. '\u' escapes are handled separately
+        constexpr auto escape_values = []() {
+            std::array<char, 256> result = {};
+            result['"'] = '"';
+            result['\\'] = '\\';
+            result['/'] = '/';
+            result['b'] = '\b';
+            result['f'] = '\f';
+            result['n'] = '\n';
+            result['r'] = '\r';
+            result['t'] = '\t';
+            return result;
+        }();
+
+        constexpr bool is_high_surrogate(char32_t ch) noexcept
+        {
+            return in_range(ch, 0xD800, 0xDBFF);
+        }
+
+        constexpr bool is_low_surrogate(char32_t ch) noexcept
+        {
+            return in_range(ch, 0xDC00, 0xDFFF);
+        }
+    }
+
     template <typename T>
     concept InputStream = requires(T value) {
                               typename T::char_type;
@@ -111,6 +172,192 @@ namespace json
                                   } -> Utf8Char;
                           };
 
+    // An input stream whose remaining data is contiguous in memory, starting at 'read' and ending at 'end'. Consumers
+    // may read from and advance 'read' directly
+    template <typename T>
+    concept ContiguousInputStream = InputStream<T> && requires(T value, const typename T::char_type* ptr) {
+                                                          {
+                                                              value.read
+                                                              } -> std::convertible_to<const typename T::char_type*>;
+                                                          {
+                                                              value.end
+                                                              } -> std::convertible_to<const typename T::char_type*>;
+                                                          value.read = ptr;
+                                                      };
+
+    namespace details
+    {
+        // Scans a number starting at 'begin', returning a pointer to the first character after it, or 'nullptr' if the
+        // text is not a valid JSON number
+        template <Utf8Char CharT>
+        constexpr const CharT* scan_number(const CharT* begin, const CharT* end) noexcept
+        {
+            auto ptr = begin;
+            auto digits = [&]() {
+                auto start = ptr;
+                while ((ptr != end) && is_digit(*ptr)) ++ptr;
+                return ptr != start;
+            };
+
+            if ((ptr != end) && (*ptr == '-')) ++ptr;
+            if ((ptr == end) || !is_digit(*ptr)) return nullptr;
+            if (*ptr == '0') ++ptr;
+            else digits();
+
+            if ((ptr != end) && (*ptr == '.'))
+            {
+                ++ptr;
+                if (!digits()) return nullptr;
+            }
+
+            if ((ptr != end) && ((*ptr == 'e') || (*ptr == 'E')))
+            {
+                ++ptr;
+                if ((ptr != end) && ((*ptr == '-') || (*ptr == '+'))) ++ptr;
+                if (!digits()) return nullptr;
+            }
+
+            return ptr;
+        }
+
+        // Word-at-a-time helpers. Each returns a mask with the high bit set for every byte of 'word' matching the
+        // condition, and no other bits set
+        constexpr std::uint64_t swar_ones = 0x0101010101010101;
+        constexpr std::uint64_t swar_low_bits = 0x7F7F7F7F7F7F7F7F;
+        constexpr std::uint64_t swar_high_bits = 0x8080808080808080;
+
+        constexpr std::uint64_t swar_equal(std::uint64_t word, unsigned char ch) noexcept
+        {
+            auto diff = word ^ (swar_ones * ch);
+            return ~(((diff & swar_low_bits) + swar_low_bits) | diff) & swar_high_bits;
+        }
+
+        constexpr std::uint64_t swar_less(std::uint64_t word, unsigned char ch) noexcept
+        {
+            // NOTE: Only valid for 'ch' in the range [1, 0x80]
+            return ~(((word & swar_low_bits) + swar_ones * (0x80 - ch)) | word) & swar_high_bits;
+        }
+
+        constexpr std::uint64_t swar_whitespace(std::uint64_t word) noexcept
+        {
+            return swar_equal(word, ' ') | swar_equal(word, '\n') | swar_equal(word, '\r') | swar_equal(word, '\t');
+        }
+
+        // Finds the first character in [ptr, end) that satisfies 'pred'. 'wordMask' must compute the equivalent of
+        // 'pred' for each byte of a word per the above. Whole words are read while they lie before 'readableEnd'
+        template <Utf8Char CharT, typename WordMask, typename Pred>
+        inline const CharT* find_first(const CharT* ptr, const CharT* end, const CharT* readableEnd,
+            WordMask&& wordMask, Pred&& pred) noexcept
+        {
+            if constexpr (std::endian::native == std::endian::little)
+            {
+                while ((ptr < end) && (readableEnd - ptr >= 8))
+                {
+                    std::uint64_t word;
+                    std::memcpy(&word, ptr, sizeof(word));
+                    if (auto mask = wordMask(word))
+                    {
+                        ptr += std::countr_zero(mask) / 8;
+                        return (ptr < end) ? ptr : end;
+                    }
+
+                    ptr += 8;
+                }
+
+                if (ptr > end) return end;
+            }
+
+            while ((ptr != end) && !pred(*ptr)) ++ptr;
+            return ptr;
+        }
+
+        // The end of the region that can be read from a contiguous stream
+        template <ContiguousInputStream InputStreamT>
+        constexpr auto readable_end(const InputStreamT& input) noexcept
+        {
+            if constexpr (requires { input.padding; }) return input.end + input.padding;
+            else return input.end;
+        }
+    }
+
+    // Number of readable characters that a 'padded_buffer' guarantees past the end of its data. This is large enough
+    // for a full 512-bit load starting at the last character, so scanning code never needs to special case the tail
+    constexpr std::size_t padding_size = 64;
+
+    // A buffer followed by 'padding_size' readable, zero-initialized characters
+    template <Utf8Char CharT>
+    class padded_buffer
+    {
+    public:
+        using char_type = CharT;
+
+        padded_buffer() : padded_buffer(0)
+        {
+        }
+
+        explicit padded_buffer(std::size_t size)
+        {
+            resize(size);
+        }
+
+        padded_buffer(std::basic_string_view<CharT> str) : padded_buffer(str.size())
+        {
+            std::memcpy(buffer.get(), str.data(), str.size() * sizeof(CharT));
+        }
+
+        CharT* data() noexcept
+        {
+            return buffer.get();
+        }
+
+        const CharT* data() const noexcept
+        {
+            return buffer.get();
+        }
+
+        std::size_t size() const noexcept
+        {
+            return length;
+        }
+
+        // Existing contents are preserved up to the new size. Existing capacity is reused when possible
+        void resize(std::size_t size)
+        {
+            if (!buffer || (size > capacity))
+            {
+                std::unique_ptr<CharT[]> newBuffer(new CharT[size + padding_size]);
+                if (buffer) std::memcpy(newBuffer.get(), buffer.get(), length * sizeof(CharT));
+                buffer = std::move(newBuffer);
+                capacity = size;
+            }
+
+            length = size;
+            std::memset(buffer.get() + size, 0, padding_size * sizeof(CharT));
+        }
+
+    private:
+        std::unique_ptr<CharT[]> buffer;
+        std::size_t length = 0;
+        std::size_t capacity = 0;
+    };
+
+    using padded_string = padded_buffer<char>;
+
+    // Reads the entire contents of a file into 'target'
+    template <Utf8Char CharT>
+    inline bool read_file(const char* path, padded_buffer<CharT>& target)
+    {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file) return false;
+
+        auto size = static_cast<std::streamoff>(file.tellg());
+        if (size < 0) return false;
+        if (!file.seekg(0)) return false;
+
+        target.resize(static_cast<std::size_t>(size) / sizeof(CharT));
+        return !!file.read(reinterpret_cast<char*>(target.data()), target.size() * sizeof(CharT));
+    }
+
     template <Utf8Char CharT>
     struct buffer_input_stream
     {
@@ -118,9 +365,14 @@ namespace json
 
         const CharT* read;
         const CharT* end;
+        std::size_t padding = 0; // Number of characters past 'end' that are safe to read
 
         buffer_input_stream(const CharT* begin, const CharT* end) noexcept : read(begin), end(end) {}
         buffer_input_stream(std::string_view str) noexcept : buffer_input_stream(str.data(), str.data() + str.size()) {}
+        buffer_input_stream(const padded_buffer<CharT>& buffer) noexcept :
+            read(buffer.data()), end(buffer.data() + buffer.size()), padding(padding_size)
+        {
+        }
 
         constexpr operator bool() const noexcept
         {
@@ -204,13 +456,27 @@ namespace json
     {
         using char_type = typename InputStreamT::char_type;
 
-        InputStreamT& input;
+        InputStreamT* input;
         lexer_token current_token = lexer_token::eof; // Since we hard stop on invalid; 'advance' will work correctly
         std::basic_string<char_type> string_value;
         const char_type* error_text = nullptr;
 
-        lexer(InputStreamT& input) : input(input)
+        // For contiguous streams, the first character of 'current_token' (or the end of the input at eof). Unused for
+        // other streams
+        const char_type* token_begin = nullptr;
+
+        lexer(InputStreamT& input) : input(&input)
+        {
+            advance();
+        }
+
+        // Rebinds the lexer to a new input stream and reads its first token. Any previous state, including errors, is
+        // discarded, however the capacity of 'string_value' is retained so that lexing a sequence of documents does not
+        // need to reallocate it for each one
+        void reset(InputStreamT& newInput)
         {
+            input = &newInput;
+            current_token = lexer_token::eof;
             advance();
         }
 
@@ -222,20 +488,21 @@ namespace json
             string_value.clear();
 
             skip_whitespace();
-            if (input.eof())
+            if constexpr (ContiguousInputStream<InputStreamT>) token_begin = input->read;
+            if (input->eof())
             {
                 current_token = lexer_token::eof;
                 return;
             }
 
             current_token = lexer_token::invalid;
-            if (!input)
+            if (!*input)
             {
                 error_text = JSON_LEXER_SELECT_TEXT("Bad unicode");
                 return;
             }
 
-            auto ch = input.get();
+            auto ch = input->get();
             switch (ch)
             {
             case '{':
@@ -307,92 +574,109 @@ namespace json
     private:
         void skip_whitespace()
         {
-            while (is_whitespace(input.peek()))
+            if constexpr (ContiguousInputStream<InputStreamT>)
             {
-                input.get();
+                input->read = details::find_first(
+                    input->read, input->end, details::readable_end(*input),
+                    [](std::uint64_t word) { return ~details::swar_whitespace(word) & details::swar_high_bits; },
+                    [](char_type ch) { return !is_whitespace(ch); });
             }
+            else
+            {
+                while (is_whitespace(input->peek()))
+                {
+                    input->get();
+                }
+            }
+        }
+
+        static constexpr bool is_string_special(char_type ch) noexcept
+        {
+            // Characters that end a run of characters that can be copied as-is
+            auto value = static_cast<unsigned char>(ch);
+            return (value == '"') || (value == '\\') || (value < 0x20) || (ch == static_cast<char_type>(invalid_char));
         }
 
         void process_string()
         {
             // NOTE: The leading '"' character should already be "consumed"
-            while (true)
+            if constexpr (ContiguousInputStream<InputStreamT>)
             {
-                auto ch = input.get();
-                if (ch == invalid_char)
+                auto ptr = input->read;
+                auto end = input->end;
+                auto readableEnd = details::readable_end(*input);
+                while (true)
                 {
-                    string_value.clear();
-                    error_text = input.eof() ? JSON_LEXER_SELECT_TEXT("Unterminated string") :
-                                               JSON_LEXER_SELECT_TEXT("Bad unicode");
-                    return;
-                }
-                else if (ch == '"')
-                {
-                    // End of the string
-                    break;
-                }
-                else if (ch == '\\')
-                {
-                    ch = input.get();
-                    switch (ch)
+                    // Copy the longest run of characters that don't need any special handling all at once
+                    auto run = ptr;
+                    ptr = details::find_first(
+                        ptr, end, readableEnd,
+                        [](std::uint64_t word) {
+                            return details::swar_equal(word, '"') | details::swar_equal(word, '\\') |
+                                details::swar_less(word, 0x20) | details::swar_equal(word, 0xFF);
+                        },
+                        is_string_special);
+                    string_value.append(run, ptr);
+
+                    if ((ptr == end) || (*ptr == static_cast<char_type>(invalid_char)))
                     {
-                    case '"':
-                    case '\\':
-                    case '/': string_value.push_back(static_cast<char_type>(ch)); break;
-                    case 'b': string_value.push_back('\b'); break;
-                    case 'f': string_value.push_back('\f'); break;
-                    case 'n': string_value.push_back('\n'); break;
-                    case 'r': string_value.push_back('\r'); break;
-                    case 't': string_value.push_back('\t'); break;
-                    case 'u': {
-                        char32_t decodedValue = 0;
-                        for (std::size_t i = 0; i < 4; ++i)
-                        {
-                            decodedValue <<= 4;
-                            ch = input.get();
-                            if (is_digit(ch))
-                            {
-                                decodedValue |= (ch - '0');
-                            }
-                            else if (details::in_range(ch, 'a', 'f'))
-                            {
-                                decodedValue |= 10 + (ch - 'a');
-                            }
-                            else if (details::in_range(ch, 'A', 'F'))
-                            {
-                                decodedValue |= 10 + (ch - 'A');
-                            }
-                            else
-                            {
-                                string_value.clear();
-                                error_text = input.eof() ? JSON_LEXER_SELECT_TEXT("Unterminated string") :
-                                                           JSON_LEXER_SELECT_TEXT("Bad unicode");
-                                return;
-                            }
-                        }
-
-                        // NOTE: Can't fail since max of 4 hex digits
-                        utf8_append(string_value, decodedValue);
+                        string_value.clear();
+                        error_text = (ptr == end) ? JSON_LEXER_SELECT_TEXT("Unterminated string") :
+                                                    JSON_LEXER_SELECT_TEXT("Bad unicode");
+                        input->read = ptr;
+                        return;
                     }
-                    break;
-
-                    default:
+                    else if (*ptr == '"')
+                    {
+                        input->read = ptr + 1;
+                        break;
+                    }
+                    else if (*ptr == '\\')
+                    {
+                        input->read = ptr + 1;
+                        if (!process_escape()) return;
+                        ptr = input->read;
+                    }
+                    else
+                    {
                         string_value.clear();
-                        error_text = input.eof() ? JSON_LEXER_SELECT_TEXT("Unterminated string") :
-                            input                ? JSON_LEXER_SELECT_TEXT("Unknown escape character") :
-                                                   JSON_LEXER_SELECT_TEXT("Bad unicode");
+                        error_text = JSON_LEXER_SELECT_TEXT("Control character in string");
+                        input->read = ptr;
                         return;
                     }
                 }
-                else if (static_cast<unsigned char>(ch) < 0x20)
-                {
-                    string_value.clear();
-                    error_text = JSON_LEXER_SELECT_TEXT("Control character in string");
-                    return;
-                }
-                else
+            }
+            else
+            {
+                while (true)
                 {
-                    string_value.push_back(ch);
+                    auto ch = input->get();
+                    if (ch == invalid_char)
+                    {
+                        string_value.clear();
+                        error_text = input->eof() ? JSON_LEXER_SELECT_TEXT("Unterminated string") :
+                                                   JSON_LEXER_SELECT_TEXT("Bad unicode");
+                        return;
+                    }
+                    else if (ch == '"')
+                    {
+                        // End of the string
+                        break;
+                    }
+                    else if (ch == '\\')
+                    {
+                        if (!process_escape()) return;
+                    }
+                    else if (static_cast<unsigned char>(ch) < 0x20)
+                    {
+                        string_value.clear();
+                        error_text = JSON_LEXER_SELECT_TEXT("Control character in string");
+                        return;
+                    }
+                    else
+                    {
+                        string_value.push_back(ch);
+                    }
                 }
             }
 
@@ -402,12 +686,113 @@ namespace json
             current_token = lexer_token::string;
         }
 
+        bool process_escape()
+        {
+            // NOTE: The leading '\\' character should already be "consumed"
+            auto ch = input->get();
+            if (auto value = details::escape_values[static_cast<unsigned char>(ch)])
+            {
+                string_value.push_back(static_cast<char_type>(value));
+                return true;
+            }
+            else if (ch != 'u')
+            {
+                return escape_error(JSON_LEXER_SELECT_TEXT("Unknown escape character"));
+            }
+
+            auto codePoint = read_hex_quad();
+            if (codePoint < 0) return escape_error(JSON_LEXER_SELECT_TEXT("Bad unicode"));
+
+            if (details::is_high_surrogate(codePoint))
+            {
+                // Characters outside the BMP are encoded as a UTF-16 surrogate pair, e.g. '\uD83D\uDE00', which we need
+                // to combine into a single code point
+                if ((input->get() != '\\') || (input->get() != 'u'))
+                    return escape_error(JSON_LEXER_SELECT_TEXT("Unpaired surrogate"));
+
+                auto low = read_hex_quad();
+                if (low < 0) return escape_error(JSON_LEXER_SELECT_TEXT("Bad unicode"));
+                if (!details::is_low_surrogate(low)) return escape_error(JSON_LEXER_SELECT_TEXT("Unpaired surrogate"));
+
+                codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+            }
+            else if (details::is_low_surrogate(codePoint))
+            {
+                return escape_error(JSON_LEXER_SELECT_TEXT("Unpaired surrogate"));
+            }
+
+            // NOTE: Can't fail since we've verified the code point is in range
+            utf8_append(string_value, static_cast<char32_t>(codePoint));
+            return true;
+        }
+
+        bool escape_error(const char_type* text)
+        {
+            string_value.clear();
+            error_text = input->eof() ? JSON_LEXER_SELECT_TEXT("Unterminated string") :
+                *input               ? text :
+                                       JSON_LEXER_SELECT_TEXT("Bad unicode");
+            return false;
+        }
+
+        std::int32_t read_hex_quad()
+        {
+            if constexpr (ContiguousInputStream<InputStreamT>)
+            {
+                if (input->end - input->read < 4)
+                {
+                    input->read = input->end;
+                    return -1;
+                }
+
+                auto result = details::decode_hex_quad(input->read);
+                if (result >= 0) input->read += 4;
+                return result;
+            }
+            else
+            {
+                char_type digits[4];
+                for (auto& digit : digits) digit = input->get();
+                return details::decode_hex_quad(digits);
+            }
+        }
+
         void process_number(char_type ch)
         {
+            if constexpr (ContiguousInputStream<InputStreamT>)
+            {
+                // Scan the number in place and copy it all at once
+                auto begin = input->read - 1; // 'ch' has already been consumed
+                auto first = (ch == '-') ? input->read : begin;
+                if ((first == input->end) || !is_digit(*first))
+                {
+                    error_text = JSON_LEXER_SELECT_TEXT("Unknown value");
+                    return;
+                }
+
+                auto ptr = details::scan_number(begin, input->end);
+                if (!ptr)
+                {
+                    error_text = JSON_LEXER_SELECT_TEXT("Invalid number");
+                    return;
+                }
+
+                input->read = ptr;
+                if (!next_is_separating_character())
+                {
+                    error_text = JSON_LEXER_SELECT_TEXT("Invalid number");
+                    return;
+                }
+
+                string_value.assign(begin, ptr);
+                current_token = lexer_token::number;
+                return;
+            }
+
             if (ch == '-')
             {
                 string_value.push_back('-');
-                ch = input.get();
+                ch = input->get();
             }
 
             // Must at least have a leading zero
@@ -421,49 +806,49 @@ namespace json
             string_value.push_back(static_cast<char_type>(ch));
             if (ch != '0')
             {
-                while (is_digit(input.peek()))
+                while (is_digit(input->peek()))
                 {
-                    string_value.push_back(static_cast<char_type>(input.get()));
+                    string_value.push_back(static_cast<char_type>(input->get()));
                 }
             }
 
-            if (input.peek() == '.')
+            if (input->peek() == '.')
             {
-                input.get();
+                input->get();
                 string_value.push_back('.');
 
-                if (!is_digit(input.peek()))
+                if (!is_digit(input->peek()))
                 {
                     string_value.clear();
                     error_text = JSON_LEXER_SELECT_TEXT("Invalid number");
                     return;
                 }
 
-                while (is_digit(input.peek()))
+                while (is_digit(input->peek()))
                 {
-                    string_value.push_back(static_cast<char>(input.get()));
+                    string_value.push_back(static_cast<char>(input->get()));
                 }
             }
 
-            if ((input.peek() == 'e') || (input.peek() == 'E'))
+            if ((input->peek() == 'e') || (input->peek() == 'E'))
             {
-                string_value.push_back(static_cast<char_type>(input.get()));
+                string_value.push_back(static_cast<char_type>(input->get()));
 
-                if ((input.peek() == '-') || (input.peek() == '+'))
+                if ((input->peek() == '-') || (input->peek() == '+'))
                 {
-                    string_value.push_back(static_cast<char_type>(input.get()));
+                    string_value.push_back(static_cast<char_type>(input->get()));
                 }
 
-                if (!is_digit(input.peek()))
+                if (!is_digit(input->peek()))
                 {
                     string_value.clear();
                     error_text = JSON_LEXER_SELECT_TEXT("Invalid number");
                     return;
                 }
 
-                while (is_digit(input.peek()))
+                while (is_digit(input->peek()))
                 {
-                    string_value.push_back(static_cast<char_type>(input.get()));
+                    string_value.push_back(static_cast<char_type>(input->get()));
                 }
             }
 
@@ -480,13 +865,27 @@ namespace json
 
         bool try_consume_remaining_string(std::string_view remainder)
         {
-            for (auto ch : remainder)
+            if constexpr (ContiguousInputStream<InputStreamT>)
             {
-                if (ch != input.get())
+                if ((static_cast<std::size_t>(input->end - input->read) < remainder.size()) ||
+                    (std::memcmp(input->read, remainder.data(), remainder.size()) != 0))
                 {
                     error_text = JSON_LEXER_SELECT_TEXT("Unknown value");
                     return false;
                 }
+
+                input->read += remainder.size();
+            }
+            else
+            {
+                for (auto ch : remainder)
+                {
+                    if (ch != input->get())
+                    {
+                        error_text = JSON_LEXER_SELECT_TEXT("Unknown value");
+                        return false;
+                    }
+                }
             }
 
             // We still need to validate that this was not just a substring.
@@ -501,8 +900,8 @@ namespace json
 
         bool next_is_separating_character()
         {
-            auto ch = input.peek();
-            if (input.eof()) return true;
+            auto ch = input->peek();
+            if (input->eof()) return true;
 
             // There's no true "great" definition of what defines a JSON lexer token. E.g. the string "truefalse" should
             // obviously not be treated as two separate tokens ("true" followed by "false"), however the handling of
@@ -519,4 +918,18 @@ namespace json
             else return utf8;
         }
     };
+
+    // Returns a lexer for 'input' that is reused by all calls on the same thread for the same stream type, keeping its
+    // buffers allocated across documents. The returned lexer is only valid until the next call on the same thread, so
+    // it must not be used for nested or interleaved parsing. Functions in this library that parse text internally
+    // (e.g. 'parse_cache::get') never use it, so they are safe to call while parsing with it
+    template <InputStream InputStreamT>
+    inline lexer<InputStreamT>& thread_lexer(InputStreamT& input)
+    {
+        thread_local std::optional<lexer<InputStreamT>> instance;
+        if (instance) instance->reset(input);
+        else instance.emplace(input);
+
+        return *instance;
+    }
 }
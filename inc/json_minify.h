@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+
+#include "json_parser.h"
+
+namespace json
+{
+    namespace details
+    {
+        // Copies '[ptr, end)' to 'out', skipping whitespace outside of strings. Returns a pointer past the last
+        // character written, or null if a string is unterminated
+        inline char* minify_text(const char* ptr, const char* end, char* out) noexcept
+        {
+            auto copy = [&](const char* from, const char* to) {
+                std::memcpy(out, from, static_cast<std::size_t>(to - from));
+                out += to - from;
+            };
+
+            while (ptr != end)
+            {
+                // Everything up to the next whitespace or string is copied as-is
+                auto run = ptr;
+                ptr = find_first(
+                    ptr, end, end, [](std::uint64_t word) { return swar_whitespace(word) | swar_equal(word, '"'); },
+                    [](char ch) { return is_whitespace(ch) || (ch == '"'); });
+                copy(run, ptr);
+                if (ptr == end) break;
+
+                if (*ptr != '"')
+                {
+                    ptr = find_first(
+                        ptr, end, end, [](std::uint64_t word) { return ~swar_whitespace(word) & swar_high_bits; },
+                        [](char ch) { return !is_whitespace(ch); });
+                    continue;
+                }
+
+                // Strings are copied verbatim, so only quotes and backslashes matter for finding where they end
+                run = ptr++;
+                while (true)
+                {
+                    ptr = find_first(
+                        ptr, end, end,
+                        [](std::uint64_t word) { return swar_equal(word, '"') | swar_equal(word, '\\'); },
+                        [](char ch) { return (ch == '"') || (ch == '\\'); });
+                    if (ptr == end) return nullptr;
+                    if (*ptr == '"') break;
+
+                    // Skip the escaped character, which may be a quote
+                    if (end - ptr < 2) return nullptr;
+                    ptr += 2;
+                }
+
+                ++ptr;
+                copy(run, ptr);
+            }
+
+            return out;
+        }
+    }
+
+    // Appends 'input' to 'output' with all whitespace outside of strings removed. Strings are copied verbatim, without
+    // decoding their escape sequences, so this is considerably faster than lexing the input and writing each token
+    // back out. Without 'validate', the input is assumed to be valid JSON and only unterminated strings are detected.
+    // With 'validate', the input must consist of exactly one valid JSON value. Validation is a full lex of the input,
+    // decoding every string, before the copy, so it costs about as much as parsing with 'ignore_value'. 'input' may
+    // refer to the contents of 'output'. On failure, 'output' is unchanged
+    inline bool minify(std::string_view input, std::string& output, bool validate = false)
+    {
+        if (validate)
+        {
+            buffer_input_stream<char> stream(input);
+            lexer lexer(stream);
+            if (!ignore_value(lexer) || (lexer.current_token != lexer_token::eof)) return false;
+        }
+
+        // Resizing 'output' may reallocate it, so an input that refers to it is copied first
+        std::less<const char*> less;
+        if (!input.empty() && !less(input.data(), output.data()) && less(input.data(), output.data() + output.size()))
+        {
+            std::string copy(input);
+            return minify(copy, output);
+        }
+
+        // The output is never larger than the input, so it is written in place and then trimmed
+        auto previousSize = output.size();
+        output.resize(previousSize + input.size());
+        auto end = details::minify_text(input.data(), input.data() + input.size(), output.data() + previousSize);
+        output.resize(end ? static_cast<std::size_t>(end - output.data()) : previousSize);
+        return end != nullptr;
+    }
+}
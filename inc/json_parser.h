@@ -1,7 +1,11 @@
 #pragma once
 
+#include <algorithm>
 #include <charconv>
+#include <limits>
+#include <string_view>
 #include <system_error>
+#include <vector>
 
 #include "json_lexer.h"
 
@@ -78,153 +82,168 @@ namespace json
         return true;
     }
 
-    template <InputStream InputStreamT, Number NumberT>
-    inline bool parse_number(lexer<InputStreamT>& lexer, NumberT& target) noexcept
+    namespace details
     {
-        if (lexer.current_token != lexer_token::number) return false;
-
-        auto fromChars = [](std::string_view str, auto& number) {
-            auto begin = str.data();
-            auto end = begin + str.size();
-            auto [ptr, ec] = std::from_chars(begin, end, number);
-            return (ptr == end) && (ec == std::errc{});
-        };
-
-        NumberT result;
-        if constexpr (std::is_floating_point_v<NumberT>)
+        // Converts the text of a JSON number to 'NumberT', failing if the value cannot be represented exactly by an
+        // integral type, or is out of range
+        template <Number NumberT>
+        inline bool parse_number_text(std::string_view text, NumberT& target) noexcept
         {
-            if (!fromChars(lexer.string_value, result)) return false;
-        }
-        else if constexpr (sizeof(NumberT) <= 6)
-        {
-            // <= 48-bit integer can fit inside of a 64-bit double, which is much simpler to parse and verify
-            double numberFloat;
-            if (!fromChars(lexer.string_value, numberFloat)) return false;
+            if (text.empty()) return false;
 
-            result = static_cast<NumberT>(numberFloat);
-            if (static_cast<double>(result) != numberFloat) return false;
-        }
-        else
-        {
-            // > 48-bit integer cannot fit inside of a 64-bit double, so we need to do a bit of manual work
-            bool negative = false;
-            std::string_view coeffWholeStr;
-            std::string_view coeffFractionStr;
-            std::string_view exponentStr;
-
-            std::string_view remainder = lexer.string_value;
-            if (remainder.front() == '-')
+            auto fromChars = [](std::string_view str, auto& number) {
+                auto begin = str.data();
+                auto end = begin + str.size();
+                auto [ptr, ec] = std::from_chars(begin, end, number);
+                return (ptr == end) && (ec == std::errc{});
+            };
+
+            NumberT result;
+            if constexpr (std::is_floating_point_v<NumberT>)
             {
-                if constexpr (!std::is_signed_v<NumberT>) return false;
-                else
-                {
-                    negative = true;
-                    remainder = remainder.substr(1);
-                }
+                if (!fromChars(text, result)) return false;
             }
-
-            auto pos = remainder.find_first_of(".eE");
-            if (pos == std::string::npos)
+            else if constexpr (sizeof(NumberT) <= 6)
             {
-                coeffWholeStr = remainder;
+                // <= 48-bit integer can fit inside of a 64-bit double, which is much simpler to parse and verify
+                double numberFloat;
+                if (!fromChars(text, numberFloat)) return false;
+
+                result = static_cast<NumberT>(numberFloat);
+                if (static_cast<double>(result) != numberFloat) return false;
             }
             else
             {
-                auto ch = remainder[pos];
-                coeffWholeStr = remainder.substr(0, pos);
-                remainder = remainder.substr(pos + 1);
-
-                if (ch == '.')
+                // > 48-bit integer cannot fit inside of a 64-bit double, so we need to do a bit of manual work
+                bool negative = false;
+                std::string_view coeffWholeStr;
+                std::string_view coeffFractionStr;
+                std::string_view exponentStr;
+
+                std::string_view remainder = text;
+                if (remainder.front() == '-')
                 {
-                    pos = remainder.find_first_of("eE");
-                    if (pos == std::string::npos)
-                    {
-                        // We need to allow something like '42.0'
-                        coeffFractionStr = remainder;
-                    }
+                    if constexpr (!std::is_signed_v<NumberT>) return false;
                     else
                     {
-                        coeffFractionStr = remainder.substr(0, pos);
-                        exponentStr = remainder.substr(pos + 1);
+                        negative = true;
+                        remainder = remainder.substr(1);
                     }
                 }
-                else
-                {
-                    exponentStr = remainder;
-                }
 
-                if (!exponentStr.empty() && (exponentStr.front() == '+'))
+                auto pos = remainder.find_first_of(".eE");
+                if (pos == std::string::npos)
                 {
-                    exponentStr = exponentStr.substr(1); // from_chars doesn't allow a leading '+'
+                    coeffWholeStr = remainder;
                 }
-            }
-
-            int exponent = 0;
-            if (!exponentStr.empty() && !fromChars(exponentStr, exponent)) return false;
-
-            std::make_unsigned_t<NumberT> resultUnsigned;
-            if (exponent <= 0)
-            {
-                // E.g. must be something like '420.0e-1' to remain integral
-                if (coeffFractionStr.find_first_not_of('0') != std::string_view::npos) return false;
+                else
+                {
+                    auto ch = remainder[pos];
+                    coeffWholeStr = remainder.substr(0, pos);
+                    remainder = remainder.substr(pos + 1);
 
-                auto shiftLen = std::min(static_cast<std::size_t>(-exponent), coeffWholeStr.size());
-                auto coeffWholeUpper = coeffWholeStr.substr(0, coeffWholeStr.size() - shiftLen);
-                auto coeffWholeLower = coeffWholeStr.substr(coeffWholeUpper.size());
-                if (coeffWholeLower.find_first_not_of('0') != std::string_view::npos) return false;
+                    if (ch == '.')
+                    {
+                        pos = remainder.find_first_of("eE");
+                        if (pos == std::string::npos)
+                        {
+                            // We need to allow something like '42.0'
+                            coeffFractionStr = remainder;
+                        }
+                        else
+                        {
+                            coeffFractionStr = remainder.substr(0, pos);
+                            exponentStr = remainder.substr(pos + 1);
+                        }
+                    }
+                    else
+                    {
+                        exponentStr = remainder;
+                    }
 
-                // The remainder is our number
-                if (!fromChars(coeffWholeUpper, resultUnsigned)) return false;
-            }
-            else
-            {
-                // E.g. must be something like '4.20e1' if there's a fraction
-                auto shiftLen = std::min(static_cast<std::size_t>(exponent), coeffFractionStr.size());
-                auto coeffFractionUpper = coeffFractionStr.substr(0, shiftLen);
-                auto coeffFractionLower = coeffFractionStr.substr(shiftLen);
-                if (coeffFractionLower.find_first_not_of('0') != std::string_view::npos) return false;
-
-                auto pow10 = [&](int amt) {
-                    for (int i = 0; i < amt; ++i)
+                    if (!exponentStr.empty() && (exponentStr.front() == '+'))
                     {
-                        // TODO: Better way to do this and detect overflow?
-                        auto newResult = resultUnsigned * 10;
-                        if (newResult < resultUnsigned) return false;
-                        resultUnsigned = newResult;
+                        exponentStr = exponentStr.substr(1); // from_chars doesn't allow a leading '+'
                     }
-                    return true;
-                };
+                }
 
-                // We're going to read the fraction as-is, so multiply by the power of 10 up to the shift
-                if (!fromChars(coeffWholeStr, resultUnsigned)) return false;
-                if (!pow10(static_cast<int>(shiftLen))) return false;
+                int exponent = 0;
+                if (!exponentStr.empty() && !fromChars(exponentStr, exponent)) return false;
 
-                std::make_unsigned_t<NumberT> fraction;
-                if (!fromChars(coeffFractionUpper, fraction)) return false;
+                std::make_unsigned_t<NumberT> resultUnsigned;
+                if (exponent <= 0)
+                {
+                    // E.g. must be something like '420.0e-1' to remain integral
+                    if (coeffFractionStr.find_first_not_of('0') != std::string_view::npos) return false;
 
-                auto newResult = resultUnsigned + fraction;
-                if (newResult < resultUnsigned) return false;
-                resultUnsigned = newResult;
+                    auto shiftLen = std::min(static_cast<std::size_t>(-exponent), coeffWholeStr.size());
+                    auto coeffWholeUpper = coeffWholeStr.substr(0, coeffWholeStr.size() - shiftLen);
+                    auto coeffWholeLower = coeffWholeStr.substr(coeffWholeUpper.size());
+                    if (coeffWholeLower.find_first_not_of('0') != std::string_view::npos) return false;
 
-                if (!pow10(exponent - static_cast<int>(shiftLen))) return false;
-            }
+                    // The remainder is our number
+                    if (!fromChars(coeffWholeUpper, resultUnsigned)) return false;
+                }
+                else
+                {
+                    // E.g. must be something like '4.20e1' if there's a fraction
+                    auto shiftLen = std::min(static_cast<std::size_t>(exponent), coeffFractionStr.size());
+                    auto coeffFractionUpper = coeffFractionStr.substr(0, shiftLen);
+                    auto coeffFractionLower = coeffFractionStr.substr(shiftLen);
+                    if (coeffFractionLower.find_first_not_of('0') != std::string_view::npos) return false;
+
+                    constexpr auto maxUnsigned = std::numeric_limits<std::make_unsigned_t<NumberT>>::max();
+                    auto pow10 = [&](int amt) {
+                        for (int i = 0; i < amt; ++i)
+                        {
+                            // NOTE: A product that overflows may wrap around past the original value, so check first
+                            if (resultUnsigned > maxUnsigned / 10) return false;
+                            resultUnsigned *= 10;
+                        }
+                        return true;
+                    };
+
+                    // We're going to read the fraction as-is, so multiply by the power of 10 up to the shift
+                    if (!fromChars(coeffWholeStr, resultUnsigned)) return false;
+                    if (!pow10(static_cast<int>(shiftLen))) return false;
+
+                    // E.g. '1e2' has no fraction at all
+                    std::make_unsigned_t<NumberT> fraction = 0;
+                    if (!coeffFractionUpper.empty() && !fromChars(coeffFractionUpper, fraction)) return false;
+
+                    auto newResult = resultUnsigned + fraction;
+                    if (newResult < resultUnsigned) return false;
+                    resultUnsigned = newResult;
+
+                    if (!pow10(exponent - static_cast<int>(shiftLen))) return false;
+                }
 
-            if (negative)
-            {
-                result = static_cast<NumberT>(~resultUnsigned + 1);
-                if (result > 0) return false;
-            }
-            else
-            {
-                result = static_cast<NumberT>(resultUnsigned);
-                if constexpr (std::is_signed_v<NumberT>)
+                if (negative)
+                {
+                    result = static_cast<NumberT>(~resultUnsigned + 1);
+                    if (result > 0) return false;
+                }
+                else
                 {
-                    if (result < 0) return false;
+                    result = static_cast<NumberT>(resultUnsigned);
+                    if constexpr (std::is_signed_v<NumberT>)
+                    {
+                        if (result < 0) return false;
+                    }
                 }
             }
+
+            target = result;
+            return true;
         }
+    }
+
+    template <InputStream InputStreamT, Number NumberT>
+    inline bool parse_number(lexer<InputStreamT>& lexer, NumberT& target) noexcept
+    {
+        if (lexer.current_token != lexer_token::number) return false;
+        if (!details::parse_number_text(lexer.string_value, target)) return false;
 
-        target = result;
         lexer.advance();
         return true;
     }
@@ -327,6 +346,130 @@ namespace json
         return true;
     }
 
+    namespace details
+    {
+        // Converts a number that has already been validated by 'scan_number'. Plain integers and floating point
+        // targets go straight to 'from_chars'; anything else follows the rules of 'parse_number'
+        template <Number NumberT>
+        inline bool convert_scanned_number(const char* begin, const char* end, NumberT& target) noexcept
+        {
+            if constexpr (std::is_integral_v<NumberT>)
+            {
+                if (std::find_if(begin, end, [](char ch) { return !is_digit(ch) && (ch != '-'); }) != end)
+                    return parse_number_text(std::string_view(begin, end - begin), target);
+            }
+
+            auto [ptr, ec] = std::from_chars(begin, end, target);
+            return (ptr == end) && (ec == std::errc{});
+        }
+
+        // Appends the numbers of the array at the current token to 'target', which is not cleared first. On a
+        // contiguous stream, the array is scanned directly from the input buffer rather than one token at a time
+        template <Number NumberT, InputStream InputStreamT>
+        inline bool append_number_array(lexer<InputStreamT>& lexer, std::vector<NumberT>& target)
+        {
+            using char_type = typename InputStreamT::char_type;
+            if constexpr (ContiguousInputStream<InputStreamT> && std::is_same_v<char_type, char>)
+            {
+                if (lexer.current_token != lexer_token::bracket_open) return false;
+
+                auto& input = *lexer.input;
+                auto ptr = input.read;
+                auto end = input.end;
+                auto skipWhitespace = [&] {
+                    while ((ptr != end) && is_whitespace(*ptr)) ++ptr;
+                };
+
+                // Reserve space for the whole array up front. Only nested arrays or strings could contain a ']' or
+                // ',' before the end of the array, and those fail below, so this count is exact for valid input
+                if (auto close = std::find(ptr, end, ']'); close != end)
+                {
+                    target.reserve(target.size() + std::count(ptr, close, ',') + 1);
+                }
+
+                auto fail = [&](const char* error) {
+                    input.read = ptr;
+                    lexer.current_token = lexer_token::invalid;
+                    lexer.error_text = error;
+                    return false;
+                };
+
+                skipWhitespace();
+                if ((ptr != end) && (*ptr == ']'))
+                {
+                    input.read = ptr + 1;
+                    lexer.advance();
+                    return true;
+                }
+
+                while (true)
+                {
+                    auto numberEnd = scan_number(ptr, end);
+                    if (!numberEnd) return fail("Invalid number");
+
+                    NumberT value;
+                    if (!convert_scanned_number(ptr, numberEnd, value)) return fail("Number out of range");
+                    target.push_back(value);
+
+                    ptr = numberEnd;
+                    skipWhitespace();
+                    if (ptr == end) return fail("Unterminated array");
+                    if (*ptr == ']') break;
+                    if (*ptr != ',') return fail("Expected ',' or ']'");
+
+                    ++ptr;
+                    skipWhitespace();
+                }
+
+                input.read = ptr + 1;
+                lexer.advance();
+                return true;
+            }
+            else
+            {
+                return parse_array(lexer, target, [](auto& lexer, auto& target) {
+                    NumberT value;
+                    if (!parse_number(lexer, value)) return false;
+                    target.push_back(value);
+                    return true;
+                });
+            }
+        }
+    }
+
+    // Parses an array consisting only of numbers into 'target', replacing its contents. This is considerably faster
+    // than 'parse_array' with a 'parse_number' callback for large arrays read from a contiguous stream (e.g. a
+    // 'buffer_input_stream'), since the numbers are scanned directly from the input, without producing a token for
+    // each one. Other streams fall back to 'parse_array'
+    template <Number NumberT, InputStream InputStreamT>
+    inline bool parse_number_array(lexer<InputStreamT>& lexer, std::vector<NumberT>& target)
+    {
+        target.clear();
+        return details::append_number_array(lexer, target);
+    }
+
+    // Parses an array of equally sized arrays of numbers into 'target' in row-major order, replacing its contents. E.g.
+    // '[[1, 2, 3], [4, 5, 6]]' produces two rows and three columns
+    template <Number NumberT, InputStream InputStreamT>
+    inline bool parse_number_matrix(
+        lexer<InputStreamT>& lexer, std::vector<NumberT>& target, std::size_t& rows, std::size_t& columns)
+    {
+        target.clear();
+        rows = 0;
+        columns = 0;
+        return parse_array(lexer, target, [&](auto& lexer, auto& target) {
+            auto previousSize = target.size();
+            if (!details::append_number_array(lexer, target)) return false;
+
+            auto rowSize = target.size() - previousSize;
+            if (rows == 0) columns = rowSize;
+            else if (rowSize != columns) return false;
+
+            ++rows;
+            return true;
+        });
+    }
+
     namespace details
     {
         template <InputStream InputStreamT>
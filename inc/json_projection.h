@@ -0,0 +1,189 @@
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "json_parser.h"
+
+namespace json
+{
+    namespace details
+    {
+        // Invokes 'callback' with each decoded reference token of the JSON Pointer (RFC 6901) 'pointer'. Returns false
+        // if the pointer is malformed, e.g. does not start with '/' or contains an invalid '~' escape
+        template <typename Func>
+        inline bool for_each_pointer_token(std::string_view pointer, Func&& callback)
+        {
+            if (pointer.empty()) return true; // The whole document
+            if (pointer.front() != '/') return false;
+
+            std::string token;
+            std::size_t pos = 1;
+            while (true)
+            {
+                auto next = pointer.find('/', pos);
+                auto text = pointer.substr(pos, (next == std::string_view::npos) ? std::string_view::npos : next - pos);
+
+                token.clear();
+                for (std::size_t i = 0; i < text.size(); ++i)
+                {
+                    if (text[i] != '~')
+                    {
+                        token.push_back(text[i]);
+                        continue;
+                    }
+
+                    if (++i == text.size()) return false;
+                    if (text[i] == '0') token.push_back('~');
+                    else if (text[i] == '1') token.push_back('/');
+                    else return false;
+                }
+
+                if (!callback(std::string_view(token))) return false;
+
+                if (next == std::string_view::npos) break;
+                pos = next + 1;
+            }
+
+            return true;
+        }
+
+        // Array indices in a JSON Pointer are either '0' or a number without leading zeros
+        inline std::size_t pointer_array_index(std::string_view token) noexcept
+        {
+            constexpr auto npos = std::numeric_limits<std::size_t>::max();
+            if (token.empty() || (token.size() > 1 && token.front() == '0')) return npos;
+
+            std::size_t result = 0;
+            for (auto ch : token)
+            {
+                if (!is_digit(ch)) return npos;
+                if (result > (npos - 9) / 10) return npos;
+                result = result * 10 + (ch - '0');
+            }
+
+            return result;
+        }
+    }
+
+    template <typename Func, typename InputStreamT>
+    concept ProjectionCallback = requires(Func fn, lexer<InputStreamT> lexer, std::size_t index) {
+                                     {
+                                         fn(lexer, index)
+                                         } -> std::convertible_to<bool>;
+                                 };
+
+    // A compiled set of JSON Pointers that can be matched against a document in a single pass. Paths are identified by
+    // the order in which they were added, starting at zero. Once built, a projection is immutable and can be reused
+    // (including concurrently) for any number of documents
+    class projection
+    {
+    public:
+        static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+        projection() : nodes(1)
+        {
+        }
+
+        // Adds a path to the projection. Fails if the pointer is malformed, or if it is the same as, a prefix of, or
+        // prefixed by a path that has already been added since a value can only be consumed once
+        bool add(std::string_view pointer)
+        {
+            auto nodeCount = nodes.size();
+            std::size_t current = 0;
+            auto result = details::for_each_pointer_token(pointer, [&](std::string_view token) {
+                if (nodes[current].path_index != npos) return false;
+
+                auto& children = nodes[current].children;
+                auto itr = std::lower_bound(children.begin(), children.end(), token,
+                    [&](std::size_t child, std::string_view token) { return nodes[child].token < token; });
+                if ((itr != children.end()) && (nodes[*itr].token == token))
+                {
+                    current = *itr;
+                    return true;
+                }
+
+                auto child = nodes.size();
+                children.insert(itr, child);
+                nodes.push_back(node{ std::string(token), details::pointer_array_index(token), npos, {} });
+                current = child;
+                return true;
+            });
+
+            if (!result || (nodes[current].path_index != npos) || !nodes[current].children.empty())
+            {
+                // Roll back any nodes we added so that the projection remains unchanged
+                for (auto& node : nodes)
+                {
+                    std::erase_if(node.children, [&](std::size_t child) { return child >= nodeCount; });
+                }
+                nodes.resize(nodeCount);
+                return false;
+            }
+
+            nodes[current].path_index = path_count++;
+            return true;
+        }
+
+        std::size_t size() const noexcept
+        {
+            return path_count;
+        }
+
+        // Consumes the value at the lexer's current token, invoking 'callback' with the lexer and the path index for
+        // each value that matches a path in the projection. The callback is responsible for consuming the matched
+        // value, the same as for 'parse_object'/'parse_array'. All other values are skipped
+        template <InputStream InputStreamT>
+        bool run(lexer<InputStreamT>& lexer, ProjectionCallback<InputStreamT> auto&& callback) const
+        {
+            return dispatch(lexer, 0, callback);
+        }
+
+    private:
+        struct node
+        {
+            std::string token;
+            std::size_t array_index = npos;
+            std::size_t path_index = npos;
+            std::vector<std::size_t> children; // Sorted by 'token'
+        };
+
+        template <InputStream InputStreamT, typename Callback>
+        bool dispatch(lexer<InputStreamT>& lexer, std::size_t index, Callback& callback) const
+        {
+            auto& current = nodes[index];
+            if (current.path_index != npos) return callback(lexer, current.path_index);
+            if (current.children.empty()) return ignore_value(lexer);
+
+            switch (lexer.current_token)
+            {
+            case lexer_token::curly_open:
+                return parse_object(lexer, nullptr, [&](auto& lexer, auto&&, auto& name) {
+                    auto itr = std::lower_bound(current.children.begin(), current.children.end(), name,
+                        [&](std::size_t child, const auto& name) { return nodes[child].token < name; });
+                    if ((itr == current.children.end()) || (nodes[*itr].token != name)) return ignore_value(lexer);
+                    return dispatch(lexer, *itr, callback);
+                });
+
+            case lexer_token::bracket_open: {
+                std::size_t arrayIndex = 0;
+                return parse_array(lexer, nullptr, [&](auto& lexer, auto&&) {
+                    auto itr = std::find_if(current.children.begin(), current.children.end(),
+                        [&](std::size_t child) { return nodes[child].array_index == arrayIndex; });
+                    ++arrayIndex;
+                    if (itr == current.children.end()) return ignore_value(lexer);
+                    return dispatch(lexer, *itr, callback);
+                });
+            }
+
+            default: return ignore_value(lexer);
+            }
+        }
+
+        std::vector<node> nodes; // The root is always at index zero
+        std::size_t path_count = 0;
+    };
+}
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <charconv>
+#include <limits>
+#include <string_view>
+#include <vector>
+
+#include "json_parser.h"
+
+namespace json
+{
+    // Receives events from 'sax_parse'. Each function returns false to stop parsing. String views refer to the lexer's
+    // buffer and are only valid for the duration of the call. 'on_number' receives both the number's text exactly as
+    // it appeared in the input and its value as a 'double'. Numbers whose magnitude is too large or too small for a
+    // 'double' (e.g. '1e400' or '1e-400') are still valid JSON; their value is given as infinity or zero respectively
+    template <typename T, typename CharT>
+    concept SaxHandler = requires(T handler, std::basic_string_view<CharT> str, double num, bool flag) {
+                             { handler.on_null() } -> std::convertible_to<bool>;
+                             { handler.on_boolean(flag) } -> std::convertible_to<bool>;
+                             { handler.on_number(str, num) } -> std::convertible_to<bool>;
+                             { handler.on_string(str) } -> std::convertible_to<bool>;
+                             { handler.on_object_begin() } -> std::convertible_to<bool>;
+                             { handler.on_key(str) } -> std::convertible_to<bool>;
+                             { handler.on_object_end() } -> std::convertible_to<bool>;
+                             { handler.on_array_begin() } -> std::convertible_to<bool>;
+                             { handler.on_array_end() } -> std::convertible_to<bool>;
+                         };
+
+    namespace details
+    {
+        // The value of a JSON number that 'from_chars' reports as out of range for a 'double': infinity if its
+        // magnitude is too large, or zero if it is too small
+        inline double out_of_range_double(std::string_view text) noexcept
+        {
+            auto negative = text.front() == '-';
+            if (negative) text.remove_prefix(1);
+
+            // The number is '0.ddd * 10^(magnitude + exponent)', where the first 'd' is non-zero
+            auto exponentPos = text.find_first_of("eE");
+            auto mantissa = text.substr(0, exponentPos);
+            long long magnitude;
+            if (mantissa.front() != '0')
+            {
+                // The number of digits before the decimal point
+                auto point = mantissa.find('.');
+                magnitude = static_cast<long long>((point == std::string_view::npos) ? mantissa.size() : point);
+            }
+            else
+            {
+                // Minus the number of zeros between the decimal point and the first non-zero digit
+                auto firstDigit = mantissa.find_first_not_of('0', 2);
+                if (firstDigit == std::string_view::npos) return negative ? -0.0 : 0.0;
+                magnitude = -static_cast<long long>(firstDigit - 2);
+            }
+
+            long long exponent = 0;
+            if (exponentPos != std::string_view::npos)
+            {
+                auto exponentText = text.substr(exponentPos + 1);
+                auto exponentNegative = exponentText.front() == '-';
+                if ((exponentText.front() == '-') || (exponentText.front() == '+')) exponentText.remove_prefix(1);
+                for (auto ch : exponentText)
+                {
+                    // Anything this large is out of range regardless of the mantissa, so stop before overflowing
+                    if (exponent > 1'000'000) break;
+                    exponent = exponent * 10 + (ch - '0');
+                }
+
+                if (exponentNegative) exponent = -exponent;
+            }
+
+            auto result = (magnitude + exponent > 0) ? std::numeric_limits<double>::infinity() : 0.0;
+            return negative ? -result : result;
+        }
+    }
+
+    // Consumes a single value from 'lexer', invoking the corresponding functions on 'handler' as each token is read.
+    // Unlike 'parse_object'/'parse_array', nesting is tracked with an explicit stack rather than recursion, so
+    // arbitrarily deep documents can be processed. Returns false if the input is malformed or a handler function
+    // returns false
+    template <InputStream InputStreamT, SaxHandler<typename InputStreamT::char_type> HandlerT>
+    inline bool sax_parse(lexer<InputStreamT>& lexer, HandlerT& handler)
+    {
+        using string_view_type = std::basic_string_view<typename InputStreamT::char_type>;
+
+        std::vector<bool> stack; // True for objects, false for arrays
+
+        // Reads a member name and the following colon, leaving the lexer at the start of the member's value
+        auto readKey = [&]() {
+            if (lexer.current_token != lexer_token::string) return false;
+            if (!handler.on_key(string_view_type(lexer.string_value))) return false;
+            lexer.advance();
+
+            if (lexer.current_token != lexer_token::colon) return false;
+            lexer.advance();
+            return true;
+        };
+
+        while (true)
+        {
+            // The lexer is at the start of a value
+            switch (lexer.current_token)
+            {
+            case lexer_token::curly_open:
+                if (!handler.on_object_begin()) return false;
+                lexer.advance();
+                if (lexer.current_token != lexer_token::curly_close)
+                {
+                    if (!readKey()) return false;
+                    stack.push_back(true);
+                    continue;
+                }
+
+                if (!handler.on_object_end()) return false;
+                break;
+
+            case lexer_token::bracket_open:
+                if (!handler.on_array_begin()) return false;
+                lexer.advance();
+                if (lexer.current_token != lexer_token::bracket_close)
+                {
+                    stack.push_back(false);
+                    continue;
+                }
+
+                if (!handler.on_array_end()) return false;
+                break;
+
+            case lexer_token::string:
+                if (!handler.on_string(string_view_type(lexer.string_value))) return false;
+                break;
+
+            case lexer_token::number: {
+                auto begin = reinterpret_cast<const char*>(lexer.string_value.data());
+                auto end = begin + lexer.string_value.size();
+                double value;
+                auto [ptr, ec] = std::from_chars(begin, end, value);
+                if (ptr != end) return false;
+                if (ec == std::errc::result_out_of_range) value = details::out_of_range_double({ begin, end });
+                else if (ec != std::errc{}) return false;
+                if (!handler.on_number(string_view_type(lexer.string_value), value)) return false;
+                break;
+            }
+
+            case lexer_token::keyword_true:
+            case lexer_token::keyword_false:
+                if (!handler.on_boolean(lexer.current_token == lexer_token::keyword_true)) return false;
+                break;
+
+            case lexer_token::keyword_null:
+                if (!handler.on_null()) return false;
+                break;
+
+            default: return false;
+            }
+
+            // The lexer is at the last token of a value; close any containers that end after it
+            lexer.advance();
+            while (true)
+            {
+                if (stack.empty()) return true;
+
+                auto isObject = stack.back();
+                if (lexer.current_token == lexer_token::comma)
+                {
+                    lexer.advance();
+                    if (isObject && !readKey()) return false;
+                    break;
+                }
+
+                if (lexer.current_token != (isObject ? lexer_token::curly_close : lexer_token::bracket_close))
+                    return false;
+
+                stack.pop_back();
+                if (!(isObject ? handler.on_object_end() : handler.on_array_end())) return false;
+                lexer.advance();
+            }
+        }
+    }
+}
@@ -0,0 +1,264 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <string_view>
+#include <utility>
+
+#include "json_parser.h"
+
+// Compile-time schemas describing a subset of JSON Schema. A schema is a type built from the templates below, which
+// 'json::schema::validate' turns into a single pass validating parser. E.g.
+//
+//      using user_schema = json::schema::object<
+//          json::schema::property<"id", json::schema::integer<1>>,
+//          json::schema::property<"role", json::schema::string_enum<"admin", "user">>,
+//          json::schema::property<"tags", json::schema::array<json::schema::string>, false>>;
+//
+//      if (!json::schema::validate<user_schema>(lexer)) { ... }
+//
+// Validation fails on the first token that violates the schema, without building a DOM
+namespace json::schema
+{
+    // String literal usable as a template argument
+    template <std::size_t N>
+    struct fixed_string
+    {
+        constexpr fixed_string(const char (&str)[N]) noexcept
+        {
+            for (std::size_t i = 0; i < N; ++i) value[i] = str[i];
+        }
+
+        constexpr std::string_view view() const noexcept
+        {
+            return std::string_view(value, N - 1);
+        }
+
+        char value[N];
+    };
+
+    struct null
+    {
+    };
+
+    struct boolean
+    {
+    };
+
+    struct string
+    {
+    };
+
+    // Any well-formed JSON value
+    struct any
+    {
+    };
+
+    // A number within the inclusive range [Min, Max]
+    template <std::int64_t Min = std::numeric_limits<std::int64_t>::min(),
+        std::int64_t Max = std::numeric_limits<std::int64_t>::max()>
+    struct number
+    {
+    };
+
+    // An integral number within the inclusive range [Min, Max]. Numbers such as '4.2e1' are integral
+    template <std::int64_t Min = std::numeric_limits<std::int64_t>::min(),
+        std::int64_t Max = std::numeric_limits<std::int64_t>::max()>
+    struct integer
+    {
+    };
+
+    // A string that is equal to one of 'Values'
+    template <fixed_string... Values>
+    struct string_enum
+    {
+    };
+
+    // An array whose elements all match 'Item', with between 'MinItems' and 'MaxItems' elements (inclusive)
+    template <typename Item, std::size_t MinItems = 0, std::size_t MaxItems = std::numeric_limits<std::size_t>::max()>
+    struct array
+    {
+    };
+
+    // A member of an 'object' schema
+    template <fixed_string Name, typename Schema, bool Required = true>
+    struct property
+    {
+        static constexpr std::string_view name = Name.view();
+        using schema = Schema;
+        static constexpr bool required = Required;
+    };
+
+    // An object with the given 'property' members. As in JSON Schema, members that are not listed are allowed and
+    // are skipped. Listed members may only appear once
+    template <typename... Properties>
+    struct object
+    {
+    };
+
+    namespace details
+    {
+        template <typename Schema>
+        struct validator;
+
+        template <>
+        struct validator<null>
+        {
+            template <InputStream InputStreamT>
+            static bool run(lexer<InputStreamT>& lexer)
+            {
+                return ignore_null(lexer);
+            }
+        };
+
+        template <>
+        struct validator<boolean>
+        {
+            template <InputStream InputStreamT>
+            static bool run(lexer<InputStreamT>& lexer)
+            {
+                return ignore_bool(lexer);
+            }
+        };
+
+        template <>
+        struct validator<string>
+        {
+            template <InputStream InputStreamT>
+            static bool run(lexer<InputStreamT>& lexer)
+            {
+                return ignore_string(lexer);
+            }
+        };
+
+        template <>
+        struct validator<any>
+        {
+            template <InputStream InputStreamT>
+            static bool run(lexer<InputStreamT>& lexer)
+            {
+                return ignore_value(lexer);
+            }
+        };
+
+        template <std::int64_t Min, std::int64_t Max>
+        struct validator<number<Min, Max>>
+        {
+            template <InputStream InputStreamT>
+            static bool run(lexer<InputStreamT>& lexer)
+            {
+                constexpr bool unbounded = (Min == std::numeric_limits<std::int64_t>::min()) &&
+                                           (Max == std::numeric_limits<std::int64_t>::max());
+                if constexpr (unbounded) return ignore_number(lexer);
+                else
+                {
+                    double value;
+                    if (!parse_number(lexer, value)) return false;
+                    return (value >= static_cast<double>(Min)) && (value <= static_cast<double>(Max));
+                }
+            }
+        };
+
+        template <std::int64_t Min, std::int64_t Max>
+        struct validator<integer<Min, Max>>
+        {
+            template <InputStream InputStreamT>
+            static bool run(lexer<InputStreamT>& lexer)
+            {
+                std::int64_t value;
+                if (!parse_number(lexer, value)) return false;
+                return (value >= Min) && (value <= Max);
+            }
+        };
+
+        template <fixed_string... Values>
+        struct validator<string_enum<Values...>>
+        {
+            template <InputStream InputStreamT>
+            static bool run(lexer<InputStreamT>& lexer)
+            {
+                if (lexer.current_token != lexer_token::string) return false;
+
+                std::string_view value = lexer.string_value;
+                if (!((value == Values.view()) || ...)) return false;
+
+                lexer.advance();
+                return true;
+            }
+        };
+
+        template <typename Item, std::size_t MinItems, std::size_t MaxItems>
+        struct validator<array<Item, MinItems, MaxItems>>
+        {
+            template <InputStream InputStreamT>
+            static bool run(lexer<InputStreamT>& lexer)
+            {
+                std::size_t count = 0;
+                if (!parse_array(lexer, count, [](auto& lexer, std::size_t& count) {
+                        return (++count <= MaxItems) && validator<Item>::run(lexer);
+                    }))
+                    return false;
+
+                return count >= MinItems;
+            }
+        };
+
+        template <typename... Properties>
+        struct validator<object<Properties...>>
+        {
+            static_assert(sizeof...(Properties) <= 64, "Object schemas are limited to 64 properties");
+
+            static constexpr std::uint64_t required_mask = []() {
+                std::uint64_t result = 0;
+                std::size_t index = 0;
+                ((result |= (Properties::required ? (std::uint64_t(1) << index) : 0), ++index), ...);
+                return result;
+            }();
+
+            template <InputStream InputStreamT>
+            static bool run(lexer<InputStreamT>& lexer)
+            {
+                std::uint64_t seen = 0;
+                if (!parse_object(lexer, seen, [](auto& lexer, std::uint64_t& seen, auto& name) {
+                        return member(lexer, seen, name, std::index_sequence_for<Properties...>{});
+                    }))
+                    return false;
+
+                return (seen & required_mask) == required_mask;
+            }
+
+        private:
+            template <InputStream InputStreamT, std::size_t... Indices>
+            static bool member(lexer<InputStreamT>& lexer, std::uint64_t& seen, std::string_view name,
+                std::index_sequence<Indices...>)
+            {
+                bool result = false;
+                auto match = [&]<std::size_t Index, typename Property>() {
+                    if (name != Property::name) return false;
+                    result = property_value<Index, Property>(lexer, seen);
+                    return true;
+                };
+
+                auto matched = (match.template operator()<Indices, Properties>() || ...);
+                return matched ? result : ignore_value(lexer);
+            }
+
+            template <std::size_t Index, typename Property, InputStream InputStreamT>
+            static bool property_value(lexer<InputStreamT>& lexer, std::uint64_t& seen)
+            {
+                constexpr auto bit = std::uint64_t(1) << Index;
+                if (seen & bit) return false; // Duplicate
+                seen |= bit;
+
+                return validator<typename Property::schema>::run(lexer);
+            }
+        };
+    }
+
+    // Consumes one value from 'lexer', returning false as soon as it is found to not match 'Schema'
+    template <typename Schema, InputStream InputStreamT>
+    inline bool validate(lexer<InputStreamT>& lexer)
+    {
+        return details::validator<Schema>::run(lexer);
+    }
+}
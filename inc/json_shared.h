@@ -0,0 +1,312 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <span>
+
+#include "json.h"
+#include "json_projection.h"
+
+namespace json
+{
+    struct shared_value;
+
+    using shared_array = std::vector<shared_value>;
+    using shared_object = std::unordered_map<string, shared_value, details::string_hash, std::equal_to<>>;
+
+    // An immutable, reference counted alternative to 'json::value'. Copies are O(1) and share the underlying data,
+    // which can never be modified in place. Instead, 'set' creates new copies of only the containers along the modified
+    // path; all other values remain shared with the original
+    struct shared_value
+    {
+        using type = std::variant<std::monostate, null, boolean, number, string, shared_array, shared_object>;
+        std::shared_ptr<const type> data;
+
+        shared_value() = default;
+
+        template <typename T, std::enable_if_t<std::is_constructible_v<type, T&&>, int> = 0>
+        shared_value(T&& value) : data(std::make_shared<const type>(std::forward<T>(value)))
+        {
+        }
+
+        explicit shared_value(const value& source)
+        {
+            std::visit(
+                [&](auto& source) {
+                    using T = std::decay_t<decltype(source)>;
+                    if constexpr (std::is_same_v<T, array>)
+                    {
+                        shared_array arr;
+                        arr.reserve(source.size());
+                        for (auto& element : source) arr.emplace_back(element);
+                        data = std::make_shared<const type>(std::move(arr));
+                    }
+                    else if constexpr (std::is_same_v<T, object>)
+                    {
+                        shared_object obj;
+                        obj.reserve(source.size());
+                        for (auto& pair : source) obj.emplace(pair.first, shared_value(pair.second));
+                        data = std::make_shared<const type>(std::move(obj));
+                    }
+                    else if constexpr (!std::is_same_v<T, std::monostate>)
+                    {
+                        data = std::make_shared<const type>(source);
+                    }
+                },
+                source.data);
+        }
+
+        template <typename T>
+        const T* get() const noexcept
+        {
+            return data ? std::get_if<T>(data.get()) : nullptr;
+        }
+
+        const null* get_null() const noexcept
+        {
+            return get<null>();
+        }
+
+        const boolean* get_boolean() const noexcept
+        {
+            return get<boolean>();
+        }
+
+        const number* get_number() const noexcept
+        {
+            return get<number>();
+        }
+
+        const string* get_string() const noexcept
+        {
+            return get<string>();
+        }
+
+        const shared_array* get_array() const noexcept
+        {
+            return get<shared_array>();
+        }
+
+        const shared_object* get_object() const noexcept
+        {
+            return get<shared_object>();
+        }
+
+        // Creates a deep, mutable copy
+        value to_value() const
+        {
+            value result;
+            if (!data) return result;
+
+            std::visit(
+                [&](auto& source) {
+                    using T = std::decay_t<decltype(source)>;
+                    if constexpr (std::is_same_v<T, shared_array>)
+                    {
+                        auto& arr = result.data.emplace<array>();
+                        arr.reserve(source.size());
+                        for (auto& element : source) arr.push_back(element.to_value());
+                    }
+                    else if constexpr (std::is_same_v<T, shared_object>)
+                    {
+                        auto& obj = result.data.emplace<object>();
+                        obj.reserve(source.size());
+                        for (auto& pair : source) obj.emplace(pair.first, pair.second.to_value());
+                    }
+                    else if constexpr (!std::is_same_v<T, std::monostate>)
+                    {
+                        result.data.template emplace<T>(source);
+                    }
+                },
+                *data);
+            return result;
+        }
+
+        // Returns the value referenced by the JSON Pointer 'pointer', or null if it does not exist
+        const shared_value* find(std::string_view pointer) const
+        {
+            auto current = this;
+            auto result = details::for_each_pointer_token(pointer, [&](std::string_view token) {
+                if (auto obj = current->get_object())
+                {
+                    auto itr = obj->find(token);
+                    if (itr == obj->end()) return false;
+                    current = &itr->second;
+                    return true;
+                }
+                else if (auto arr = current->get_array())
+                {
+                    auto index = details::pointer_array_index(token);
+                    if (index >= arr->size()) return false;
+                    current = &(*arr)[index];
+                    return true;
+                }
+
+                return false;
+            });
+
+            return result ? current : nullptr;
+        }
+
+        // Replaces the value referenced by the JSON Pointer 'pointer' with 'newValue', with the same semantics as the
+        // JSON Patch "add" operation: the final token may name a new object member, or '-' to append to an array, but
+        // all containers before it must already exist. Only the containers along the path are copied; all other values
+        // continue to be shared. Fails without modifying this value if the path is invalid
+        bool set(std::string_view pointer, shared_value newValue)
+        {
+            std::vector<std::string> tokens;
+            if (!details::for_each_pointer_token(pointer, [&](std::string_view token) {
+                    tokens.emplace_back(token);
+                    return true;
+                }))
+                return false;
+
+            auto result = set_path(*this, tokens, newValue);
+            if (!result) return false;
+
+            *this = std::move(*result);
+            return true;
+        }
+
+    private:
+        static std::optional<shared_value> set_path(const shared_value& current, std::span<const std::string> tokens,
+            shared_value& newValue)
+        {
+            if (tokens.empty()) return std::move(newValue);
+
+            auto& token = tokens.front();
+            auto remaining = tokens.subspan(1);
+            if (auto obj = current.get_object())
+            {
+                auto itr = obj->find(token);
+                if ((itr == obj->end()) && !remaining.empty()) return std::nullopt;
+
+                auto child = set_path((itr == obj->end()) ? shared_value() : itr->second, remaining, newValue);
+                if (!child) return std::nullopt;
+
+                auto copy = *obj;
+                copy.insert_or_assign(token, std::move(*child));
+                return shared_value(std::move(copy));
+            }
+            else if (auto arr = current.get_array())
+            {
+                auto index = (token == "-") ? arr->size() : details::pointer_array_index(token);
+                if ((index > arr->size()) || ((index == arr->size()) && !remaining.empty())) return std::nullopt;
+
+                auto child = set_path((index == arr->size()) ? shared_value() : (*arr)[index], remaining, newValue);
+                if (!child) return std::nullopt;
+
+                auto copy = *arr;
+                if (index == copy.size()) copy.push_back(std::move(*child));
+                else copy[index] = std::move(*child);
+                return shared_value(std::move(copy));
+            }
+
+            return std::nullopt;
+        }
+    };
+
+    template <InputStream InputStreamT>
+    inline bool parse_value(lexer<InputStreamT>& lexer, shared_value& target) noexcept
+    {
+        switch (lexer.current_token)
+        {
+        case lexer_token::curly_open: {
+            shared_object obj;
+            if (!parse_object(lexer, obj, [](auto& lexer, auto& obj, auto& name) {
+                    shared_value v;
+                    if (!parse_value(lexer, v)) return false;
+                    auto pair = obj.emplace(name, std::move(v));
+                    return pair.second;
+                }))
+                return false;
+
+            target = std::move(obj);
+            return true;
+        }
+
+        case lexer_token::bracket_open: {
+            shared_array arr;
+            if (!parse_array(lexer, arr, [](auto& lexer, auto& arr) {
+                    shared_value v;
+                    if (!parse_value(lexer, v)) return false;
+                    arr.push_back(std::move(v));
+                    return true;
+                }))
+                return false;
+
+            target = std::move(arr);
+            return true;
+        }
+
+        case lexer_token::string:
+            target = std::move(lexer.string_value);
+            lexer.advance();
+            return true;
+
+        case lexer_token::number: {
+            number num;
+            if (!parse_number(lexer, num)) return false;
+            target = num;
+            return true;
+        }
+
+        case lexer_token::keyword_true:
+            target = true;
+            lexer.advance();
+            return true;
+
+        case lexer_token::keyword_false:
+            target = false;
+            lexer.advance();
+            return true;
+
+        case lexer_token::keyword_null:
+            target = null{};
+            lexer.advance();
+            return true;
+
+        default: return false;
+        }
+    }
+
+    inline const shared_value* object_get(const shared_object& obj, std::string_view name) noexcept
+    {
+        auto itr = obj.find(name);
+        if (itr == obj.end())
+        {
+            return nullptr;
+        }
+
+        return &itr->second;
+    }
+
+    template <typename T>
+    inline const T* object_get_as(const shared_object& obj, std::string_view name) noexcept
+    {
+        auto value = object_get(obj, name);
+        if (!value) return nullptr;
+
+        return value->get<T>();
+    }
+
+    inline const shared_value* object_get(const shared_object& obj, const key& name) noexcept
+    {
+        auto itr = obj.find(name);
+        if (itr == obj.end())
+        {
+            return nullptr;
+        }
+
+        return &itr->second;
+    }
+
+    template <typename T>
+    inline const T* object_get_as(const shared_object& obj, const key& name) noexcept
+    {
+        auto value = object_get(obj, name);
+        if (!value) return nullptr;
+
+        return value->get<T>();
+    }
+}
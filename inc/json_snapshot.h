@@ -0,0 +1,695 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#ifdef _WIN32
+// Keep <windows.h> from defining 'min'/'max' macros, which break uses of 'std::min'/'std::max' in the headers below
+#ifndef NOMINMAX
+#define NOMINMAX
+#define JSON_SNAPSHOT_DEFINED_NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#define JSON_SNAPSHOT_DEFINED_WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#ifdef JSON_SNAPSHOT_DEFINED_NOMINMAX
+#undef NOMINMAX
+#undef JSON_SNAPSHOT_DEFINED_NOMINMAX
+#endif
+#ifdef JSON_SNAPSHOT_DEFINED_WIN32_LEAN_AND_MEAN
+#undef WIN32_LEAN_AND_MEAN
+#undef JSON_SNAPSHOT_DEFINED_WIN32_LEAN_AND_MEAN
+#endif
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "json.h"
+#include "json_projection.h"
+
+// A position independent binary layout of a 'json::value' that is queried in place, without deserialization. Since
+// the layout contains only offsets, a snapshot can be written to a file once and then mapped into memory (e.g. with
+// 'json::mapped_file') by any number of processes, which all share the same page cache copy. E.g.
+//
+//      std::vector<std::uint8_t> bytes;
+//      json::snapshot_encode(value, bytes);
+//      ...
+//      json::mapped_file file("data.snapshot");
+//      json::snapshot doc(file.bytes());
+//      if (auto name = doc.root().find("/user/name")) { ... }
+//
+// All integers are little endian. The layout is:
+//
+//      header:     "JSNP" | u32 version | u32 size | ref root
+//      ref:        u32 offset | type, where 'offset' is a multiple of 8 and 'type' is a 'details::snapshot_type'
+//      number:     u32 length | text | '\0'
+//      string:     u32 length | bytes | '\0'
+//      array:      u32 count | ref elements[count]
+//      object:     u32 count | (ref key, ref value)[count], sorted by key
+//
+// Numbers are stored as their original text, so that they are lossless. Identical strings (including keys) and
+// numbers are only stored once. Each string, number, array, and object is 8 byte aligned,
+// and children are always written before their parents, so that the layout cannot contain cycles
+namespace json
+{
+    namespace details
+    {
+        enum class snapshot_type : std::uint32_t
+        {
+            null = 0,
+            false_value = 1,
+            true_value = 2,
+            number = 3,
+            string = 4,
+            array = 5,
+            object = 6,
+            undefined = 7, // An uninitialized ('monostate') value
+        };
+
+        inline constexpr char snapshot_magic[4] = { 'J', 'S', 'N', 'P' };
+        inline constexpr std::uint32_t snapshot_version = 2;
+        inline constexpr std::size_t snapshot_header_size = 16;
+        inline constexpr std::uint32_t snapshot_type_mask = 7;
+
+        inline snapshot_type snapshot_ref_type(std::uint32_t ref) noexcept
+        {
+            return static_cast<snapshot_type>(ref & snapshot_type_mask);
+        }
+
+        inline std::size_t snapshot_ref_offset(std::uint32_t ref) noexcept
+        {
+            return ref & ~snapshot_type_mask;
+        }
+
+        class snapshot_writer
+        {
+        public:
+            explicit snapshot_writer(std::vector<std::uint8_t>& out) : out(out), start(out.size())
+            {
+            }
+
+            bool write(const value& root)
+            {
+                out.insert(out.end(), snapshot_header_size, 0);
+                auto rootRef = write_value(root);
+                if (failed || (out.size() - start > UINT32_MAX)) return false;
+
+                auto header = start;
+                std::memcpy(out.data() + header, snapshot_magic, sizeof(snapshot_magic));
+                put_u32(header + 4, snapshot_version);
+                put_u32(header + 8, static_cast<std::uint32_t>(out.size() - start));
+                put_u32(header + 12, rootRef);
+                return true;
+            }
+
+        private:
+            std::uint32_t write_value(const value& val)
+            {
+                if (auto str = val.get_string()) return write_string(*str);
+                if (auto num = val.get_number())
+                {
+                    // Numbers share the layout of strings, so identical text is only stored once
+                    auto textRef = write_string(num->text());
+                    return make_ref(snapshot_ref_offset(textRef), snapshot_type::number);
+                }
+                if (auto arr = val.get_array())
+                {
+                    std::vector<std::uint32_t> refs;
+                    refs.reserve(arr->size());
+                    for (auto& element : *arr) refs.push_back(write_value(element));
+
+                    auto offset = begin_record();
+                    append_u32(static_cast<std::uint32_t>(refs.size()));
+                    for (auto ref : refs) append_u32(ref);
+                    return make_ref(offset, snapshot_type::array);
+                }
+                if (auto obj = val.get_object())
+                {
+                    std::vector<const object::value_type*> members;
+                    members.reserve(obj->size());
+                    for (auto& pair : *obj) members.push_back(&pair);
+                    std::sort(members.begin(), members.end(), [](auto lhs, auto rhs) {
+                        return lhs->first < rhs->first;
+                    });
+
+                    std::vector<std::uint32_t> refs;
+                    refs.reserve(members.size() * 2);
+                    for (auto member : members)
+                    {
+                        refs.push_back(write_string(member->first));
+                        refs.push_back(write_value(member->second));
+                    }
+
+                    auto offset = begin_record();
+                    append_u32(static_cast<std::uint32_t>(members.size()));
+                    for (auto ref : refs) append_u32(ref);
+                    return make_ref(offset, snapshot_type::object);
+                }
+                if (auto b = val.get_boolean())
+                    return make_ref(0, *b ? snapshot_type::true_value : snapshot_type::false_value);
+                if (val.get_null()) return make_ref(0, snapshot_type::null);
+                return make_ref(0, snapshot_type::undefined);
+            }
+
+            std::uint32_t write_string(std::string_view str)
+            {
+                auto [itr, inserted] = strings.try_emplace(str, 0);
+                if (!inserted) return itr->second;
+
+                auto offset = begin_record();
+                append_u32(static_cast<std::uint32_t>(str.size()));
+                out.insert(out.end(), str.begin(), str.end());
+                out.push_back(0);
+                if (str.size() > UINT32_MAX) failed = true;
+
+                itr->second = make_ref(offset, snapshot_type::string);
+                return itr->second;
+            }
+
+            // Pads the output to the next 8 byte boundary, returning the offset of the new record
+            std::size_t begin_record()
+            {
+                out.resize(start + ((out.size() - start + 7) & ~std::size_t(7)), 0);
+                return out.size() - start;
+            }
+
+            std::uint32_t make_ref(std::size_t offset, snapshot_type type) noexcept
+            {
+                if (offset > UINT32_MAX) failed = true;
+                return static_cast<std::uint32_t>(offset) | static_cast<std::uint32_t>(type);
+            }
+
+            void append_u32(std::uint32_t value)
+            {
+                for (int i = 0; i < 4; ++i) out.push_back(static_cast<std::uint8_t>(value >> (i * 8)));
+            }
+
+            void put_u32(std::size_t pos, std::uint32_t value) noexcept
+            {
+                for (int i = 0; i < 4; ++i) out[pos + i] = static_cast<std::uint8_t>(value >> (i * 8));
+            }
+
+            std::vector<std::uint8_t>& out;
+            std::size_t start;
+            std::unordered_map<std::string_view, std::uint32_t> strings;
+            bool failed = false;
+        };
+
+        // The bytes of a snapshot. All reads are bounds checked, so corrupt data can produce wrong results, but can
+        // never read outside of the buffer
+        struct snapshot_buffer
+        {
+            const std::uint8_t* data = nullptr;
+            std::size_t size = 0;
+
+            bool read_u32(std::size_t pos, std::uint32_t& result) const noexcept
+            {
+                if ((pos > size) || (size - pos < 4)) return false;
+
+                result = 0;
+                for (int i = 3; i >= 0; --i) result = (result << 8) | data[pos + i];
+                return true;
+            }
+
+            // Reads the count of the container at 'offset', verifying that all 'count * entrySize' bytes of its
+            // entries are within the buffer
+            bool read_count(std::size_t offset, std::size_t entrySize, std::uint32_t& count) const noexcept
+            {
+                return read_u32(offset, count) && ((size - offset - 4) / entrySize >= count);
+            }
+        };
+    }
+
+    // Appends the snapshot of 'val' to 'out'. Fails if the snapshot would exceed 4GB, since offsets are 32 bits
+    inline bool snapshot_encode(const value& val, std::vector<std::uint8_t>& out)
+    {
+        auto start = out.size();
+        if (details::snapshot_writer(out).write(val)) return true;
+
+        out.resize(start);
+        return false;
+    }
+
+    class snapshot_array;
+    class snapshot_object;
+
+    // A read-only view of a value in a snapshot. Accessors return 'std::nullopt' if the value has a different type, or
+    // if its data is invalid. Views are only valid as long as the snapshot's bytes
+    class snapshot_value
+    {
+    public:
+        snapshot_value() = default;
+
+        snapshot_value(details::snapshot_buffer buffer, std::uint32_t ref) noexcept : buffer(buffer), ref(ref)
+        {
+        }
+
+        // True if this view refers to a valid value of any type
+        bool valid() const noexcept
+        {
+            return buffer.data != nullptr;
+        }
+
+        bool is_null() const noexcept
+        {
+            return valid() && (type() == details::snapshot_type::null);
+        }
+
+        std::optional<boolean> get_boolean() const noexcept
+        {
+            if (!valid()) return std::nullopt;
+            if (type() == details::snapshot_type::true_value) return true;
+            if (type() == details::snapshot_type::false_value) return false;
+            return std::nullopt;
+        }
+
+        std::optional<number> get_number() const
+        {
+            auto text = read_text(details::snapshot_type::number);
+            if (!text) return std::nullopt;
+            return number::from_text(*text);
+        }
+
+        // The text of a number, without copying it into a 'json::number'
+        std::optional<std::string_view> get_number_text() const noexcept
+        {
+            return read_text(details::snapshot_type::number);
+        }
+
+        std::optional<std::string_view> get_string() const noexcept
+        {
+            return read_text(details::snapshot_type::string);
+        }
+
+        inline std::optional<snapshot_array> get_array() const noexcept;
+        inline std::optional<snapshot_object> get_object() const noexcept;
+
+        // Returns the value as 'T', which is one of 'boolean', 'number', 'std::string_view', 'snapshot_array', or
+        // 'snapshot_object'
+        template <typename T>
+        std::optional<T> get() const
+        {
+            if constexpr (std::is_same_v<T, boolean>) return get_boolean();
+            else if constexpr (std::is_same_v<T, number>) return get_number();
+            else if constexpr (std::is_same_v<T, std::string_view>) return get_string();
+            else if constexpr (std::is_same_v<T, snapshot_array>) return get_array();
+            else
+            {
+                static_assert(std::is_same_v<T, snapshot_object>, "Unsupported snapshot type");
+                return get_object();
+            }
+        }
+
+        // Returns the value identified by the JSON Pointer (RFC 6901) 'pointer', if any
+        inline std::optional<snapshot_value> find(std::string_view pointer) const;
+
+        // Copies the value, and all values it contains, into a 'json::value'. Returns false if any data is invalid
+        inline bool to_value(value& target) const;
+
+    private:
+        friend class snapshot_array;
+        friend class snapshot_object;
+
+        details::snapshot_type type() const noexcept
+        {
+            return details::snapshot_ref_type(ref);
+        }
+
+        std::size_t offset() const noexcept
+        {
+            return details::snapshot_ref_offset(ref);
+        }
+
+        std::optional<std::string_view> read_text(details::snapshot_type expected) const noexcept
+        {
+            std::uint32_t length;
+            if (!valid() || (type() != expected) || !buffer.read_count(offset(), 1, length)) return std::nullopt;
+            return std::string_view(reinterpret_cast<const char*>(buffer.data + offset() + 4), length);
+        }
+
+        // Children are always written before their parents, so any other offset indicates corrupt data. This
+        // guarantees that traversals terminate. Null, boolean, and undefined values have an offset of zero
+        snapshot_value child(std::uint32_t childRef) const noexcept
+        {
+            if (details::snapshot_ref_offset(childRef) >= offset()) return {};
+            return snapshot_value(buffer, childRef);
+        }
+
+        details::snapshot_buffer buffer;
+        std::uint32_t ref = 0;
+    };
+
+    // A read-only view of an array in a snapshot
+    class snapshot_array
+    {
+    public:
+        snapshot_array(snapshot_value container, std::uint32_t count) noexcept : container(container), count(count)
+        {
+        }
+
+        std::size_t size() const noexcept
+        {
+            return count;
+        }
+
+        bool empty() const noexcept
+        {
+            return count == 0;
+        }
+
+        // Returns an invalid view if 'index' is out of range
+        snapshot_value operator[](std::size_t index) const noexcept
+        {
+            std::uint32_t elementRef;
+            if ((index >= count) || !container.buffer.read_u32(container.offset() + 4 + index * 4, elementRef))
+                return {};
+            return container.child(elementRef);
+        }
+
+    private:
+        snapshot_value container;
+        std::uint32_t count;
+    };
+
+    // A read-only view of an object in a snapshot. Members are sorted by key, so lookups use a binary search
+    class snapshot_object
+    {
+    public:
+        snapshot_object(snapshot_value container, std::uint32_t count) noexcept : container(container), count(count)
+        {
+        }
+
+        std::size_t size() const noexcept
+        {
+            return count;
+        }
+
+        bool empty() const noexcept
+        {
+            return count == 0;
+        }
+
+        // The key of the member at 'index', in sorted order
+        std::optional<std::string_view> key(std::size_t index) const noexcept
+        {
+            std::uint32_t keyRef;
+            if ((index >= count) || !container.buffer.read_u32(entry_offset(index), keyRef)) return std::nullopt;
+            return container.child(keyRef).get_string();
+        }
+
+        // The value of the member at 'index', in sorted order
+        snapshot_value value_at(std::size_t index) const noexcept
+        {
+            std::uint32_t valueRef;
+            if ((index >= count) || !container.buffer.read_u32(entry_offset(index) + 4, valueRef)) return {};
+            return container.child(valueRef);
+        }
+
+        std::optional<snapshot_value> find(std::string_view name) const noexcept
+        {
+            std::size_t low = 0;
+            std::size_t high = count;
+            while (low < high)
+            {
+                auto mid = low + (high - low) / 2;
+                auto midKey = key(mid);
+                if (!midKey) return std::nullopt;
+
+                auto compare = midKey->compare(name);
+                if (compare == 0) return value_at(mid);
+                if (compare < 0) low = mid + 1;
+                else high = mid;
+            }
+
+            return std::nullopt;
+        }
+
+    private:
+        std::size_t entry_offset(std::size_t index) const noexcept
+        {
+            return container.offset() + 4 + index * 8;
+        }
+
+        snapshot_value container;
+        std::uint32_t count;
+    };
+
+    inline std::optional<snapshot_array> snapshot_value::get_array() const noexcept
+    {
+        std::uint32_t count;
+        if (!valid() || (type() != details::snapshot_type::array) || !buffer.read_count(offset(), 4, count))
+            return std::nullopt;
+        return snapshot_array(*this, count);
+    }
+
+    inline std::optional<snapshot_object> snapshot_value::get_object() const noexcept
+    {
+        std::uint32_t count;
+        if (!valid() || (type() != details::snapshot_type::object) || !buffer.read_count(offset(), 8, count))
+            return std::nullopt;
+        return snapshot_object(*this, count);
+    }
+
+    inline std::optional<snapshot_value> snapshot_value::find(std::string_view pointer) const
+    {
+        auto current = *this;
+        auto success = details::for_each_pointer_token(pointer, [&](std::string_view token) {
+            if (auto obj = current.get_object())
+            {
+                auto member = obj->find(token);
+                if (!member) return false;
+                current = *member;
+            }
+            else if (auto arr = current.get_array())
+            {
+                auto index = details::pointer_array_index(token);
+                if (index >= arr->size()) return false;
+                current = (*arr)[index];
+            }
+            else
+            {
+                return false;
+            }
+
+            return current.valid();
+        });
+
+        if (!success) return std::nullopt;
+        return current;
+    }
+
+    inline bool snapshot_value::to_value(value& target) const
+    {
+        if (!valid()) return false;
+
+        switch (type())
+        {
+        case details::snapshot_type::null: target.data.emplace<null>(nullptr); return true;
+        case details::snapshot_type::false_value: target.data.emplace<boolean>(false); return true;
+        case details::snapshot_type::true_value: target.data.emplace<boolean>(true); return true;
+        case details::snapshot_type::undefined: target.data.emplace<std::monostate>(); return true;
+
+        case details::snapshot_type::number: {
+            auto num = get_number();
+            if (!num) return false;
+            target.data.emplace<number>(*num);
+            return true;
+        }
+
+        case details::snapshot_type::string: {
+            auto str = get_string();
+            if (!str) return false;
+            target.data.emplace<string>(*str);
+            return true;
+        }
+
+        case details::snapshot_type::array: {
+            auto source = get_array();
+            if (!source) return false;
+
+            auto& arr = target.data.emplace<array>();
+            arr.resize(source->size());
+            for (std::size_t i = 0; i < arr.size(); ++i)
+            {
+                if (!(*source)[i].to_value(arr[i])) return false;
+            }
+
+            return true;
+        }
+
+        case details::snapshot_type::object: {
+            auto source = get_object();
+            if (!source) return false;
+
+            auto& obj = target.data.emplace<object>();
+            obj.reserve(source->size());
+            for (std::size_t i = 0; i < source->size(); ++i)
+            {
+                auto key = source->key(i);
+                if (!key) return false;
+
+                auto [itr, inserted] = obj.try_emplace(string(*key));
+                if (!inserted || !source->value_at(i).to_value(itr->second)) return false;
+            }
+
+            return true;
+        }
+        }
+
+        return false;
+    }
+
+    inline std::optional<snapshot_value> object_get(const snapshot_object& obj, std::string_view name) noexcept
+    {
+        return obj.find(name);
+    }
+
+    template <typename T>
+    inline std::optional<T> object_get_as(const snapshot_object& obj, std::string_view name)
+    {
+        auto value = obj.find(name);
+        if (!value) return std::nullopt;
+
+        return value->get<T>();
+    }
+
+    // Snapshot objects are searched by comparison rather than by hash, so only the name of the key is used
+    inline std::optional<snapshot_value> object_get(const snapshot_object& obj, const key& name) noexcept
+    {
+        return obj.find(name.view());
+    }
+
+    template <typename T>
+    inline std::optional<T> object_get_as(const snapshot_object& obj, const key& name)
+    {
+        return object_get_as<T>(obj, name.view());
+    }
+
+    // A snapshot stored in memory that is owned elsewhere, e.g. by a 'json::mapped_file' or a 'std::vector'
+    class snapshot
+    {
+    public:
+        // Validates the header of 'data'. If it is not a snapshot, 'valid' returns false and 'root' is an invalid view
+        explicit snapshot(std::span<const std::uint8_t> data) noexcept
+        {
+            details::snapshot_buffer candidate{ data.data(), data.size() };
+            std::uint32_t version, size, rootRef;
+            if ((data.size() < details::snapshot_header_size) ||
+                (std::memcmp(data.data(), details::snapshot_magic, sizeof(details::snapshot_magic)) != 0) ||
+                !candidate.read_u32(4, version) || (version != details::snapshot_version) ||
+                !candidate.read_u32(8, size) || (size < details::snapshot_header_size) || (size > data.size()) ||
+                !candidate.read_u32(12, rootRef))
+            {
+                return;
+            }
+
+            candidate.size = size;
+            root_value = snapshot_value(candidate, rootRef);
+        }
+
+        bool valid() const noexcept
+        {
+            return root_value.valid();
+        }
+
+        explicit operator bool() const noexcept
+        {
+            return valid();
+        }
+
+        snapshot_value root() const noexcept
+        {
+            return root_value;
+        }
+
+    private:
+        snapshot_value root_value;
+    };
+
+    // A read-only memory mapping of an entire file. Pages are shared with all other processes mapping the same file
+    class mapped_file
+    {
+    public:
+        // If the file cannot be opened or mapped (or is empty), 'is_open' returns false and 'bytes' is empty
+        explicit mapped_file(const char* path) noexcept
+        {
+#ifdef _WIN32
+            auto file = ::CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file == INVALID_HANDLE_VALUE) return;
+
+            LARGE_INTEGER fileSize;
+            if (::GetFileSizeEx(file, &fileSize) && (fileSize.QuadPart > 0))
+            {
+                if (auto mapping = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr))
+                {
+                    if (auto view = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0))
+                    {
+                        data = static_cast<const std::uint8_t*>(view);
+                        size = static_cast<std::size_t>(fileSize.QuadPart);
+                    }
+
+                    ::CloseHandle(mapping);
+                }
+            }
+
+            ::CloseHandle(file);
+#else
+            auto file = ::open(path, O_RDONLY | O_CLOEXEC);
+            if (file < 0) return;
+
+            struct stat info;
+            if ((::fstat(file, &info) == 0) && (info.st_size > 0))
+            {
+                auto length = static_cast<std::size_t>(info.st_size);
+                auto view = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, file, 0);
+                if (view != MAP_FAILED)
+                {
+                    data = static_cast<const std::uint8_t*>(view);
+                    size = length;
+                }
+            }
+
+            ::close(file); // The mapping remains valid
+#endif
+        }
+
+        ~mapped_file()
+        {
+            if (!data) return;
+#ifdef _WIN32
+            ::UnmapViewOfFile(data);
+#else
+            ::munmap(const_cast<std::uint8_t*>(data), size);
+#endif
+        }
+
+        mapped_file(const mapped_file&) = delete;
+        mapped_file& operator=(const mapped_file&) = delete;
+
+        bool is_open() const noexcept
+        {
+            return data != nullptr;
+        }
+
+        std::span<const std::uint8_t> bytes() const noexcept
+        {
+            return { data, size };
+        }
+
+    private:
+        const std::uint8_t* data = nullptr;
+        std::size_t size = 0;
+    };
+}
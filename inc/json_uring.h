@@ -0,0 +1,383 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define JSON_HAS_IO_URING 1
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#else
+#define JSON_HAS_IO_URING 0
+#endif
+
+#include "json_lexer.h"
+
+namespace json
+{
+    // An 'InputStream' that reads a regular file using io_uring, keeping up to 'QueueDepth' reads of 'BlockSize' bytes
+    // in flight ahead of the lexer. As soon as the lexer finishes with a block, its buffer is reused to read the next
+    // block that is not already in flight. When io_uring is unavailable (older kernels, seccomp policies, non-Linux
+    // POSIX systems, etc.), blocks are read synchronously with 'pread' instead. This type requires POSIX, and only
+    // supports regular files; use 'json::file_source' for pipes
+    template <std::size_t BlockSize = 256 * 1024, unsigned QueueDepth = 8>
+    class uring_file_stream
+    {
+        static_assert(QueueDepth >= 2, "At least two blocks are needed for reads to overlap with lexing");
+
+    public:
+        using char_type = char;
+
+        explicit uring_file_stream(const char* path, bool allowUring = true)
+        {
+            file = ::open(path, O_RDONLY | O_CLOEXEC);
+            struct stat info;
+            if ((file < 0) || (::fstat(file, &info) != 0) || !S_ISREG(info.st_mode))
+            {
+                error = true;
+                return;
+            }
+
+            file_size = static_cast<std::size_t>(info.st_size);
+            buffers = std::make_unique<char[]>(BlockSize * QueueDepth);
+            for (unsigned i = 0; i < QueueDepth; ++i)
+            {
+                slots[i].data = buffers.get() + i * BlockSize;
+            }
+
+#if JSON_HAS_IO_URING
+            if (allowUring && ring.init(QueueDepth))
+            {
+                for (unsigned i = 0; i < QueueDepth; ++i) submit_next(slots[i]);
+                if (!ring.enter(0)) error = true;
+            }
+#else
+            (void)allowUring;
+#endif
+        }
+
+        ~uring_file_stream()
+        {
+#if JSON_HAS_IO_URING
+            // The kernel may still be writing to our buffers, so wait for all reads to complete first
+            while (in_flight > 0)
+            {
+                auto previous = in_flight;
+                reap();
+                if (in_flight == previous) break; // Waiting failed; nothing more can be done
+            }
+
+            ring.destroy();
+#endif
+            if (file >= 0) ::close(file);
+        }
+
+        uring_file_stream(const uring_file_stream&) = delete;
+        uring_file_stream& operator=(const uring_file_stream&) = delete;
+
+        // True if reads are being performed with io_uring, false if they fall back to 'pread'
+        bool uses_io_uring() const noexcept
+        {
+#if JSON_HAS_IO_URING
+            return ring.fd >= 0;
+#else
+            return false;
+#endif
+        }
+
+        operator bool()
+        {
+            return fill();
+        }
+
+        bool eof()
+        {
+            return !fill() && !error;
+        }
+
+        char get()
+        {
+            return fill() ? *read++ : invalid_char;
+        }
+
+        char peek()
+        {
+            return fill() ? *read : invalid_char;
+        }
+
+    private:
+        struct slot
+        {
+            char* data = nullptr;
+            std::size_t offset = 0; // Position in the file of 'data[0]'
+            std::size_t requested = 0; // Zero if no read has been assigned to this slot
+            std::size_t filled = 0;
+            bool complete = false;
+            iovec vec{};
+        };
+
+        bool fill()
+        {
+            if (read != end) return true;
+            if (error || (next_block_to_read >= block_count())) return false;
+
+            auto& current = slots[next_block_to_read % QueueDepth];
+#if JSON_HAS_IO_URING
+            if (uses_io_uring())
+            {
+                while (!current.complete)
+                {
+                    if (!reap()) return fail();
+                }
+            }
+            else
+#endif
+            {
+                if (current.requested == 0) assign(current, next_block_to_read);
+                while (!current.complete)
+                {
+                    auto result = ::pread(file, current.data + current.filled, current.requested - current.filled,
+                        static_cast<off_t>(current.offset + current.filled));
+                    if ((result < 0) && (errno != EINTR)) return fail();
+                    if (!complete_read(current, (result < 0) ? 0 : result, result < 0)) return fail();
+                }
+            }
+
+            if (current.filled == 0) return false; // The file shrank
+
+            read = current.data;
+            end = read + current.filled;
+            ++next_block_to_read;
+
+            // The previous block is no longer being read, so its buffer can be reused for the next block
+            release_previous();
+            return true;
+        }
+
+        bool fail() noexcept
+        {
+            error = true;
+            return false;
+        }
+
+        std::size_t block_count() const noexcept
+        {
+            return (file_size + BlockSize - 1) / BlockSize;
+        }
+
+        void assign(slot& s, std::size_t block)
+        {
+            s.offset = block * BlockSize;
+            s.requested = std::min(BlockSize, file_size - s.offset);
+            s.filled = 0;
+            s.complete = false;
+            ++next_block_to_assign;
+        }
+
+        // Records the result of a read of 'bytes' bytes. Returns false on error. If 'retry' is set, or the read was
+        // short, the remainder of the block is requested again
+        bool complete_read(slot& s, std::size_t bytes, bool retry)
+        {
+            s.filled += bytes;
+            if (!retry && ((bytes == 0) || (s.filled == s.requested)))
+            {
+                s.complete = true;
+                return true;
+            }
+
+#if JSON_HAS_IO_URING
+            if (uses_io_uring()) return submit(s) && ring.enter(0);
+#endif
+            return true;
+        }
+
+        void release_previous()
+        {
+            // The lexer has just moved off of the block before the one it is now reading, so reuse that block's slot
+            // for the next unassigned block
+            if (next_block_to_read < 2) return;
+
+            auto& previous = slots[(next_block_to_read - 2) % QueueDepth];
+            previous.requested = 0;
+
+#if JSON_HAS_IO_URING
+            if (uses_io_uring())
+            {
+                submit_next(previous);
+                if (!ring.enter(0)) error = true;
+            }
+#endif
+        }
+
+#if JSON_HAS_IO_URING
+        struct uring
+        {
+            int fd = -1;
+            void* sq_ptr = nullptr;
+            std::size_t sq_size = 0;
+            void* cq_ptr = nullptr;
+            std::size_t cq_size = 0;
+            io_uring_sqe* sqes = nullptr;
+            std::size_t sqes_size = 0;
+
+            unsigned* sq_tail = nullptr;
+            unsigned* sq_mask = nullptr;
+            unsigned* sq_array = nullptr;
+            unsigned* cq_head = nullptr;
+            unsigned* cq_tail = nullptr;
+            unsigned* cq_mask = nullptr;
+            io_uring_cqe* cqes = nullptr;
+
+            bool init(unsigned depth)
+            {
+                io_uring_params params{};
+                fd = static_cast<int>(::syscall(__NR_io_uring_setup, depth, &params));
+                if (fd < 0) return false;
+
+                sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+                cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+                auto singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+                if (singleMap) sq_size = cq_size = std::max(sq_size, cq_size);
+
+                sq_ptr = map(sq_size, IORING_OFF_SQ_RING);
+                cq_ptr = singleMap ? sq_ptr : map(cq_size, IORING_OFF_CQ_RING);
+                sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+                auto sqesPtr = map(sqes_size, IORING_OFF_SQES);
+                if (!sq_ptr || !cq_ptr || !sqesPtr)
+                {
+                    if (sqesPtr) ::munmap(sqesPtr, sqes_size);
+                    destroy();
+                    return false;
+                }
+
+                auto sq = static_cast<char*>(sq_ptr);
+                auto cq = static_cast<char*>(cq_ptr);
+                sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+                sq_mask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+                sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+                cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+                cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+                cq_mask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+                cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+                sqes = static_cast<io_uring_sqe*>(sqesPtr);
+                return true;
+            }
+
+            void* map(std::size_t size, off_t offset) const noexcept
+            {
+                auto result = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset);
+                return (result == MAP_FAILED) ? nullptr : result;
+            }
+
+            void destroy() noexcept
+            {
+                if (sqes) ::munmap(sqes, sqes_size);
+                if (cq_ptr && (cq_ptr != sq_ptr)) ::munmap(cq_ptr, cq_size);
+                if (sq_ptr) ::munmap(sq_ptr, sq_size);
+                if (fd >= 0) ::close(fd);
+                *this = uring{};
+            }
+
+            // Submits all queued entries and optionally waits for at least 'minComplete' completions
+            bool enter(unsigned minComplete) noexcept
+            {
+                while (pending > 0 || minComplete > 0)
+                {
+                    auto result = ::syscall(__NR_io_uring_enter, fd, pending, minComplete,
+                        minComplete ? IORING_ENTER_GETEVENTS : 0, nullptr, 0);
+                    if (result < 0)
+                    {
+                        if (errno == EINTR) continue;
+                        return false;
+                    }
+
+                    pending -= static_cast<unsigned>(result);
+                    minComplete = 0;
+                }
+
+                return true;
+            }
+
+            unsigned pending = 0; // Queued submission entries that have not yet been passed to 'io_uring_enter'
+        };
+
+        // Assigns the next unread block (if any) to 's' and submits a read for it
+        void submit_next(slot& s)
+        {
+            if (next_block_to_assign >= block_count()) return;
+            assign(s, next_block_to_assign);
+            if (!submit(s)) error = true;
+        }
+
+        bool submit(slot& s) noexcept
+        {
+            auto tail = std::atomic_ref(*ring.sq_tail).load(std::memory_order_relaxed);
+            auto index = tail & *ring.sq_mask;
+            auto& sqe = ring.sqes[index];
+            std::memset(&sqe, 0, sizeof(sqe));
+
+            s.vec.iov_base = s.data + s.filled;
+            s.vec.iov_len = s.requested - s.filled;
+            sqe.opcode = IORING_OP_READV;
+            sqe.fd = file;
+            sqe.addr = reinterpret_cast<std::uint64_t>(&s.vec);
+            sqe.len = 1;
+            sqe.off = s.offset + s.filled;
+            sqe.user_data = static_cast<std::uint64_t>(&s - slots);
+
+            ring.sq_array[index] = index;
+            std::atomic_ref(*ring.sq_tail).store(tail + 1, std::memory_order_release);
+            ++ring.pending;
+            ++in_flight;
+            return true;
+        }
+
+        // Processes all available completions, first waiting for at least one if none are available
+        bool reap()
+        {
+            auto head = std::atomic_ref(*ring.cq_head).load(std::memory_order_relaxed);
+            if (head == std::atomic_ref(*ring.cq_tail).load(std::memory_order_acquire))
+            {
+                if (!ring.enter(1)) return false;
+            }
+
+            auto tail = std::atomic_ref(*ring.cq_tail).load(std::memory_order_acquire);
+            bool success = true;
+            for (; head != tail; ++head)
+            {
+                auto& cqe = ring.cqes[head & *ring.cq_mask];
+                auto& s = slots[cqe.user_data];
+                --in_flight;
+                if ((cqe.res < 0) && (cqe.res != -EINTR) && (cqe.res != -EAGAIN)) success = false;
+                else if (!complete_read(s, (cqe.res < 0) ? 0 : static_cast<std::size_t>(cqe.res), cqe.res < 0))
+                    success = false;
+            }
+
+            std::atomic_ref(*ring.cq_head).store(head, std::memory_order_release);
+            return success;
+        }
+
+        uring ring;
+        unsigned in_flight = 0;
+#endif
+
+        int file = -1;
+        std::size_t file_size = 0;
+        std::unique_ptr<char[]> buffers;
+        slot slots[QueueDepth];
+        std::size_t next_block_to_read = 0; // Index of the block the lexer will read next
+        std::size_t next_block_to_assign = 0; // Index of the next block not yet assigned to a slot
+        const char* read = nullptr;
+        const char* end = nullptr;
+        bool error = false;
+    };
+}
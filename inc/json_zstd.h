@@ -0,0 +1,88 @@
+#pragma once
+
+#include <zstd.h>
+
+#include "json_block_stream.h"
+
+namespace json
+{
+    // A 'BlockSource' that incrementally decompresses zstd data read from another 'BlockSource'. Only 'InputBlockSize'
+    // compressed bytes are buffered at a time, plus the decompression window. Concatenated frames are decompressed as a
+    // single stream. E.g. to overlap decompression with lexing:
+    //
+    //      json::async_block_input_stream<json::zstd_source<json::memory_source>> stream(data, size);
+    //      json::lexer lexer(stream);
+    //
+    // Using this type requires linking against libzstd
+    template <BlockSource SourceT, std::size_t InputBlockSize = default_block_size>
+    class zstd_source
+    {
+    public:
+        template <typename... Args>
+        explicit zstd_source(Args&&... args) :
+            src(std::forward<Args>(args)...),
+            input(std::make_unique<char[]>(InputBlockSize)),
+            context(ZSTD_createDCtx())
+        {
+            error = (context == nullptr);
+        }
+
+        ~zstd_source()
+        {
+            ZSTD_freeDCtx(context);
+        }
+
+        zstd_source(const zstd_source&) = delete;
+        zstd_source& operator=(const zstd_source&) = delete;
+
+        std::size_t read(char* buffer, std::size_t size)
+        {
+            ZSTD_outBuffer out{ buffer, size, 0 };
+            while (!error && !done && (out.pos < out.size))
+            {
+                if ((in.pos == in.size) && !input_ended)
+                {
+                    in.src = input.get();
+                    in.size = src.read(input.get(), InputBlockSize);
+                    in.pos = 0;
+                    input_ended = (in.size == 0);
+                }
+
+                auto outPos = out.pos;
+                auto inPos = in.pos;
+                auto result = ZSTD_decompressStream(context, &out, &in);
+                if (ZSTD_isError(result))
+                {
+                    error = true;
+                }
+                else if ((out.pos != outPos) || (in.pos != inPos))
+                {
+                    frame_complete = (result == 0);
+                }
+                else if (input_ended)
+                {
+                    // No more data is coming, so the input must have ended on a frame boundary
+                    error = !frame_complete;
+                    done = true;
+                }
+            }
+
+            return out.pos;
+        }
+
+        bool failed() const noexcept
+        {
+            return error || src.failed();
+        }
+
+    private:
+        SourceT src;
+        std::unique_ptr<char[]> input;
+        ZSTD_DCtx* context;
+        ZSTD_inBuffer in{ nullptr, 0, 0 };
+        bool input_ended = false;
+        bool frame_complete = false; // True if the last call that made progress finished a frame
+        bool done = false;
+        bool error = false;
+    };
+}
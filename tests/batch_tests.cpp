@@ -0,0 +1,107 @@
+
+#include <json_batch.h>
+
+#include "test_guard.h"
+
+using namespace std::literals;
+
+static std::vector<std::string> make_messages(std::size_t count)
+{
+    std::vector<std::string> result;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        if (i % 10 == 9) result.push_back("{ \"id\": " + std::to_string(i) + ", }"); // Invalid
+        else result.push_back("{ \"id\": " + std::to_string(i) + ", \"name\": \"message\" }");
+    }
+
+    return result;
+}
+
+static bool check_results(json::batch_parser& parser, const std::vector<std::string_view>& messages)
+{
+    for (std::size_t i = 0; i < messages.size(); ++i)
+    {
+        auto& value = parser.results()[i];
+        if (i % 10 == 9)
+        {
+            if (parser.succeeded(i) || !std::holds_alternative<std::monostate>(value.data))
+            {
+                std::printf("ERROR: Expected message %zu to fail\n", i);
+                return false;
+            }
+
+            continue;
+        }
+
+        auto obj = value.get_object();
+        auto id = obj ? json::object_get_as<json::number>(*obj, "id") : nullptr;
+        if (!parser.succeeded(i) || !id || (*id != static_cast<double>(i)))
+        {
+            std::printf("ERROR: Incorrect result for message %zu\n", i);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static int batch_parse_test()
+{
+    test_guard guard{ "batch_parse_test" };
+
+    auto messages = make_messages(1000);
+    std::vector<std::string_view> views(messages.begin(), messages.end());
+
+    for (std::size_t threads : { 1, 3, 8 })
+    {
+        json::batch_parser parser(threads);
+        if (parser.parse(views) != 100)
+        {
+            std::printf("ERROR: Expected 100 failures with %zu threads\n", threads);
+            return 1;
+        }
+
+        if (!check_results(parser, views)) return 1;
+
+        // Parsing a smaller batch reuses the results
+        views.resize(20);
+        if ((parser.parse(views) != 2) || (parser.results().size() != 20) || !check_results(parser, views)) return 1;
+        views.assign(messages.begin(), messages.end());
+    }
+
+    // The same threads handle every batch, including batches too small to use all of them
+    json::batch_parser pooled(4);
+    for (std::size_t i = 0; i < 50; ++i)
+    {
+        auto size = (i % 2) ? views.size() : (i * 13) % views.size();
+        std::span<const std::string_view> batch(views.data(), size);
+        if ((pooled.parse(batch) != size / 10) || !check_results(pooled, { batch.begin(), batch.end() }))
+        {
+            std::printf("ERROR: Incorrect results for batch %zu of %zu messages\n", i, size);
+            return 1;
+        }
+    }
+
+    json::batch_parser parser;
+    if (parser.parse({}) || !parser.results().empty())
+    {
+        std::printf("ERROR: Expected empty batch to produce no results\n");
+        return 1;
+    }
+
+    std::string_view trailing[] = { "1 2", "", "[ 1 ]" };
+    if ((parser.parse(trailing) != 2) || !parser.succeeded(2))
+    {
+        std::printf("ERROR: Expected messages to contain exactly one value\n");
+        return 1;
+    }
+
+    return guard.success();
+}
+
+int batch_tests()
+{
+    int result = 0;
+    result += batch_parse_test();
+    return result;
+}
@@ -0,0 +1,320 @@
+
+#include <json.h>
+#include <json_block_stream.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define JSON_TEST_URING 1
+#include <json_uring.h>
+#endif
+
+#if JSON_TEST_ZLIB
+#include <json_gzip.h>
+#endif
+
+#if JSON_TEST_ZSTD
+#include <json_zstd.h>
+#endif
+
+#include "test_guard.h"
+
+using namespace std::literals;
+
+static std::string make_document()
+{
+    std::string result = "[";
+    for (int i = 0; i < 2000; ++i)
+    {
+        if (i) result += ",";
+        result += R"^-^({ "id": )^-^" + std::to_string(i) + R"^-^(, "name": "item é )^-^" + std::to_string(i) +
+                  R"^-^(", "tags": [ "a", "b" ], "ratio": 0.)^-^" + std::to_string(i) + " }";
+    }
+
+    return result + "]";
+}
+
+static const json::value& expected_value()
+{
+    static const json::value result = [] {
+        auto doc = make_document();
+        json::buffer_input_stream<char> stream(doc);
+        json::lexer lexer(stream);
+        json::value value;
+        json::parse_value(lexer, value);
+        return value;
+    }();
+    return result;
+}
+
+// Parses the whole stream and verifies that it matches 'expected_value'
+template <typename StreamT>
+static bool check_stream(StreamT& stream, const char* name)
+{
+    json::lexer lexer(stream);
+    json::value value;
+    if (!json::parse_value(lexer, value) || (lexer.current_token != json::lexer_token::eof))
+    {
+        std::printf("ERROR: Failed to parse from %s: %s\n", name, lexer.error_text ? lexer.error_text : "");
+        return false;
+    }
+
+    if (value != expected_value())
+    {
+        std::printf("ERROR: Incorrect value parsed from %s\n", name);
+        return false;
+    }
+
+    return true;
+}
+
+// Parses the stream and expects it to fail before reaching the end of the document
+template <typename StreamT>
+static bool check_stream_fails(StreamT& stream, const char* name)
+{
+    json::lexer lexer(stream);
+    json::value value;
+    if (json::parse_value(lexer, value))
+    {
+        std::printf("ERROR: Expected parsing from %s to fail\n", name);
+        return false;
+    }
+
+    return true;
+}
+
+static int block_input_stream_test()
+{
+    test_guard guard{ "block_input_stream_test" };
+
+    auto doc = make_document();
+    json::block_input_stream<json::memory_source> stream(doc);
+    json::block_input_stream<json::memory_source, 7> smallStream(doc);
+    json::async_block_input_stream<json::memory_source> asyncStream(doc);
+    json::async_block_input_stream<json::memory_source, 7, 2> smallAsyncStream(doc);
+    if (!check_stream(stream, "block_input_stream") || !check_stream(smallStream, "small block_input_stream") ||
+        !check_stream(asyncStream, "async_block_input_stream") ||
+        !check_stream(smallAsyncStream, "small async_block_input_stream"))
+        return 1;
+
+    // Destroying the stream before it is fully consumed stops the background thread
+    for (int i = 0; i < 10; ++i)
+    {
+        json::async_block_input_stream<json::memory_source, 16, 2> partial(doc);
+        if (partial.get() != '[')
+        {
+            std::printf("ERROR: Incorrect first character\n");
+            return 1;
+        }
+    }
+
+    json::block_input_stream<json::memory_source> empty(""sv);
+    json::async_block_input_stream<json::memory_source> asyncEmpty(""sv);
+    if (!empty.eof() || empty || (empty.get() != json::invalid_char) || !asyncEmpty.eof() || asyncEmpty)
+    {
+        std::printf("ERROR: Expected empty streams to be at eof\n");
+        return 1;
+    }
+
+    return guard.success();
+}
+
+static int file_source_test()
+{
+    test_guard guard{ "file_source_test" };
+
+    auto path = "file_source_test.json";
+    auto doc = make_document();
+    if (auto file = std::fopen(path, "wb"))
+    {
+        std::fwrite(doc.data(), 1, doc.size(), file);
+        std::fclose(file);
+    }
+
+    auto result = [&] {
+        json::block_input_stream<json::file_source> stream(path);
+        json::async_block_input_stream<json::file_source> asyncStream(path);
+        json::async_block_input_stream<json::file_source, 100, 3> smallAsyncStream(path);
+        if (!check_stream(stream, "file") || !check_stream(asyncStream, "async file") ||
+            !check_stream(smallAsyncStream, "small async file"))
+            return false;
+
+#if defined(__unix__) || defined(__APPLE__)
+        auto command = "cat "s + path;
+        auto pipe = ::popen(command.c_str(), "r");
+        bool pipeResult;
+        {
+            json::async_block_input_stream<json::file_source, 1000> pipeStream(pipe);
+            pipeResult = check_stream(pipeStream, "pipe");
+        }
+        ::pclose(pipe);
+        if (!pipeResult) return false;
+#endif
+
+        json::async_block_input_stream<json::file_source> missing("file_source_test_missing.json");
+        if (missing.eof() || missing)
+        {
+            std::printf("ERROR: Expected missing file to fail\n");
+            return false;
+        }
+
+        return true;
+    }();
+
+    std::remove(path);
+    return result ? guard.success() : 1;
+}
+
+#if JSON_TEST_URING
+static int uring_file_stream_test()
+{
+    test_guard guard{ "uring_file_stream_test" };
+
+    auto path = "uring_file_stream_test.json";
+    auto emptyPath = "uring_file_stream_test_empty.json";
+    auto doc = make_document();
+    if (auto file = std::fopen(path, "wb"))
+    {
+        std::fwrite(doc.data(), 1, doc.size(), file);
+        std::fclose(file);
+    }
+
+    if (auto file = std::fopen(emptyPath, "wb")) std::fclose(file);
+
+    auto result = [&] {
+        for (auto allowUring : { true, false })
+        {
+            json::uring_file_stream stream(path, allowUring);
+            json::uring_file_stream<100, 3> smallStream(path, allowUring);
+            json::uring_file_stream<4096, 2> exactStream(path, allowUring);
+            if (!allowUring && (stream.uses_io_uring() || smallStream.uses_io_uring())) return false;
+            if (!check_stream(stream, "uring_file_stream") || !check_stream(smallStream, "small uring_file_stream") ||
+                !check_stream(exactStream, "two block uring_file_stream"))
+                return false;
+
+            // Stopping partway through must wait for any reads still in flight
+            for (int i = 0; i < 10; ++i)
+            {
+                json::uring_file_stream<64, 4> partial(path, allowUring);
+                if (partial.get() != '[') return false;
+            }
+
+            json::uring_file_stream empty(emptyPath, allowUring);
+            json::uring_file_stream missing("uring_file_stream_test_missing.json", allowUring);
+            if (!empty.eof() || empty || missing.eof() || missing)
+            {
+                std::printf("ERROR: Incorrect state for empty or missing file\n");
+                return false;
+            }
+        }
+
+        return true;
+    }();
+
+    std::remove(path);
+    std::remove(emptyPath);
+    return result ? guard.success() : 1;
+}
+#endif
+
+#if JSON_TEST_ZLIB
+static std::string gzip_compress(std::string_view data)
+{
+    z_stream stream{};
+    deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, MAX_WBITS + 16, 8, Z_DEFAULT_STRATEGY);
+
+    std::string result(deflateBound(&stream, static_cast<uLong>(data.size())), '\0');
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    stream.avail_in = static_cast<uInt>(data.size());
+    stream.next_out = reinterpret_cast<Bytef*>(result.data());
+    stream.avail_out = static_cast<uInt>(result.size());
+    deflate(&stream, Z_FINISH);
+    result.resize(stream.total_out);
+    deflateEnd(&stream);
+    return result;
+}
+
+static int gzip_source_test()
+{
+    test_guard guard{ "gzip_source_test" };
+
+    auto doc = make_document();
+    auto compressed = gzip_compress(doc);
+    json::block_input_stream<json::gzip_source<json::memory_source>> stream(compressed);
+    json::block_input_stream<json::gzip_source<json::memory_source, 3>, 5> smallStream(compressed);
+    json::async_block_input_stream<json::gzip_source<json::memory_source>> asyncStream(compressed);
+    if (!check_stream(stream, "gzip") || !check_stream(smallStream, "small gzip") ||
+        !check_stream(asyncStream, "async gzip"))
+        return 1;
+
+    // Concatenated members
+    auto half = doc.size() / 2;
+    auto concatenated = gzip_compress(std::string_view(doc).substr(0, half)) +
+                        gzip_compress(std::string_view(doc).substr(half));
+    json::block_input_stream<json::gzip_source<json::memory_source>> concatenatedStream(concatenated);
+    if (!check_stream(concatenatedStream, "concatenated gzip")) return 1;
+
+    // Truncated and corrupt input
+    json::block_input_stream<json::gzip_source<json::memory_source>> truncated(
+        std::string_view(compressed).substr(0, compressed.size() / 2));
+    auto corrupt = compressed;
+    corrupt[corrupt.size() / 2] ^= 0x55;
+    corrupt[corrupt.size() / 2 + 1] ^= 0x55;
+    json::async_block_input_stream<json::gzip_source<json::memory_source>> corruptStream(corrupt);
+    if (!check_stream_fails(truncated, "truncated gzip") || !truncated.source().failed() ||
+        !check_stream_fails(corruptStream, "corrupt gzip"))
+        return 1;
+
+    return guard.success();
+}
+#endif
+
+#if JSON_TEST_ZSTD
+static std::string zstd_compress(std::string_view data)
+{
+    std::string result(ZSTD_compressBound(data.size()), '\0');
+    result.resize(ZSTD_compress(result.data(), result.size(), data.data(), data.size(), 3));
+    return result;
+}
+
+static int zstd_source_test()
+{
+    test_guard guard{ "zstd_source_test" };
+
+    auto doc = make_document();
+    auto compressed = zstd_compress(doc);
+    json::block_input_stream<json::zstd_source<json::memory_source>> stream(compressed);
+    json::block_input_stream<json::zstd_source<json::memory_source, 3>, 5> smallStream(compressed);
+    json::async_block_input_stream<json::zstd_source<json::memory_source>> asyncStream(compressed);
+    if (!check_stream(stream, "zstd") || !check_stream(smallStream, "small zstd") ||
+        !check_stream(asyncStream, "async zstd"))
+        return 1;
+
+    auto half = doc.size() / 2;
+    auto concatenated = zstd_compress(std::string_view(doc).substr(0, half)) +
+                        zstd_compress(std::string_view(doc).substr(half));
+    json::block_input_stream<json::zstd_source<json::memory_source>> concatenatedStream(concatenated);
+    if (!check_stream(concatenatedStream, "concatenated zstd")) return 1;
+
+    json::block_input_stream<json::zstd_source<json::memory_source>> truncated(
+        std::string_view(compressed).substr(0, compressed.size() / 2));
+    if (!check_stream_fails(truncated, "truncated zstd") || !truncated.source().failed()) return 1;
+
+    return guard.success();
+}
+#endif
+
+int block_stream_tests()
+{
+    int result = 0;
+    result += block_input_stream_test();
+    result += file_source_test();
+#if JSON_TEST_URING
+    result += uring_file_stream_test();
+#endif
+#if JSON_TEST_ZLIB
+    result += gzip_source_test();
+#endif
+#if JSON_TEST_ZSTD
+    result += zstd_source_test();
+#endif
+    return result;
+}
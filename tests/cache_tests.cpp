@@ -0,0 +1,194 @@
+
+#include <json_cache.h>
+#include <thread>
+#include <vector>
+
+#include "test_guard.h"
+
+using namespace std::literals;
+
+static int parse_cache_hit_test()
+{
+    test_guard guard{ "parse_cache_hit_test" };
+
+    json::parse_cache cache(1024 * 1024);
+    auto input = R"^-^({ "name": "foo", "values": [ 1, 2, 3 ] })^-^"s;
+    auto first = cache.get(input);
+    auto second = cache.get(std::string(input)); // Different buffer, same content
+    if (!first || (first != second) || (cache.size() != 1))
+    {
+        std::printf("ERROR: Expected identical input to return the cached value\n");
+        return 1;
+    }
+
+    auto name = json::object_get_as<json::string>(*first->get_object(), "name");
+    if (!name || (*name != "foo"))
+    {
+        std::printf("ERROR: Incorrect cached value\n");
+        return 1;
+    }
+
+    auto other = cache.get(R"^-^({ "name": "bar", "values": [ 1, 2, 3 ] })^-^");
+    if (!other || (other == first) || (cache.size() != 2))
+    {
+        std::printf("ERROR: Expected different input to produce a different value\n");
+        return 1;
+    }
+
+    for (auto invalid : { "", "{", "[ 1, 2 ] 3", "{ \"a\": 1, \"a\": 2 }" })
+    {
+        if (cache.get(invalid))
+        {
+            std::printf("ERROR: Expected invalid input '%s' to fail\n", invalid);
+            return 1;
+        }
+    }
+
+    if (cache.size() != 2)
+    {
+        std::printf("ERROR: Expected failures to not be cached\n");
+        return 1;
+    }
+
+    cache.clear();
+    if (cache.size() || cache.memory_usage() || (cache.get(input) == first) || (first->get_object()->size() != 2))
+    {
+        std::printf("ERROR: Expected clear to remove all entries without invalidating values\n");
+        return 1;
+    }
+
+    return guard.success();
+}
+
+static int parse_cache_eviction_test()
+{
+    test_guard guard{ "parse_cache_eviction_test" };
+
+    // A single shard to make eviction order deterministic
+    json::parse_cache cache(4096, 1);
+    std::vector<std::string> inputs;
+    for (int i = 0; i < 64; ++i)
+    {
+        inputs.push_back("[ \"" + std::string(32, 'a' + (i % 26)) + "\", " + std::to_string(i) + " ]");
+    }
+
+    auto first = cache.get(inputs[0]);
+    for (auto& input : inputs)
+    {
+        if (!cache.get(input))
+        {
+            std::printf("ERROR: Failed to parse '%s'\n", input.c_str());
+            return 1;
+        }
+
+        cache.get(inputs[0]); // Keep the first entry recently used
+        if (cache.memory_usage() > 4096)
+        {
+            std::printf("ERROR: Cache exceeded its budget\n");
+            return 1;
+        }
+    }
+
+    if ((cache.size() >= inputs.size()) || (cache.get(inputs[0]) != first))
+    {
+        std::printf("ERROR: Expected least recently used entries to be evicted\n");
+        return 1;
+    }
+
+    auto size = cache.size();
+    if (cache.get(inputs[1]) == nullptr || (cache.size() != size))
+    {
+        std::printf("ERROR: Expected evicted entries to be re-parsed\n");
+        return 1;
+    }
+
+    // Values too large for the budget are still returned
+    auto large = "\"" + std::string(8192, 'x') + "\"";
+    if (!cache.get(large) || (cache.memory_usage() > 4096))
+    {
+        std::printf("ERROR: Expected large value to be returned, but not cached\n");
+        return 1;
+    }
+
+    return guard.success();
+}
+
+static int parse_cache_thread_test()
+{
+    test_guard guard{ "parse_cache_thread_test" };
+
+    json::parse_cache cache(1024 * 1024, 4);
+    std::vector<std::string> inputs;
+    for (int i = 0; i < 16; ++i) inputs.push_back("{ \"id\": " + std::to_string(i) + " }");
+
+    std::vector<std::thread> threads;
+    std::vector<int> failures(8);
+    for (std::size_t t = 0; t < failures.size(); ++t)
+    {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < 200; ++i)
+            {
+                auto index = (i * 7 + t) % inputs.size();
+                auto value = cache.get(inputs[index]);
+                auto id = value ? json::object_get_as<json::number>(*value->get_object(), "id") : nullptr;
+                if (!id || (*id != index)) ++failures[t];
+            }
+        });
+    }
+
+    for (auto& thread : threads) thread.join();
+
+    for (auto count : failures)
+    {
+        if (count)
+        {
+            std::printf("ERROR: Incorrect value returned from cache on another thread\n");
+            return 1;
+        }
+    }
+
+    if (cache.size() != inputs.size())
+    {
+        std::printf("ERROR: Expected %zu cached values, got %zu\n", inputs.size(), cache.size());
+        return 1;
+    }
+
+    return guard.success();
+}
+
+static int parse_cache_nested_test()
+{
+    test_guard guard{ "parse_cache_nested_test" };
+
+    // Looking up a document while parsing another one with 'thread_lexer' must not disturb the outer parse
+    json::parse_cache cache(1024 * 1024);
+    auto outer = R"({ "first": "[ 1, 2 ]", "second": "{ \"a\": true }", "third": 3 })"s;
+    json::buffer_input_stream<char> stream(outer);
+    auto& lexer = json::thread_lexer(stream);
+    std::vector<std::shared_ptr<const json::value>> documents;
+    auto success = json::parse_object(lexer, documents, [&](auto& lexer, auto& documents, auto&) {
+        if (lexer.current_token != json::lexer_token::string) return json::ignore_value(lexer);
+        documents.push_back(cache.get(lexer.string_value));
+        lexer.advance();
+        return true;
+    });
+
+    if (!success || (lexer.current_token != json::lexer_token::eof) || (documents.size() != 2) || !documents[0] ||
+        !documents[1] || !documents[0]->get_array() || !documents[1]->get_object())
+    {
+        std::printf("ERROR: Cache lookup interfered with the enclosing parse\n");
+        return 1;
+    }
+
+    return guard.success();
+}
+
+int cache_tests()
+{
+    int result = 0;
+    result += parse_cache_hit_test();
+    result += parse_cache_eviction_test();
+    result += parse_cache_thread_test();
+    result += parse_cache_nested_test();
+    return result;
+}
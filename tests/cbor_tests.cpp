@@ -0,0 +1,210 @@
+
+#include <json_cbor.h>
+
+#include "test_guard.h"
+
+using namespace std::literals;
+
+static json::value parse(std::string_view text)
+{
+    json::buffer_input_stream<char> stream(text);
+    json::lexer lexer(stream);
+    json::value result;
+    json::parse_value(lexer, result);
+    return result;
+}
+
+static std::string to_hex(const std::vector<std::uint8_t>& bytes)
+{
+    std::string result;
+    for (auto byte : bytes)
+    {
+        constexpr char digits[] = "0123456789abcdef";
+        result += digits[byte >> 4];
+        result += digits[byte & 0xF];
+    }
+
+    return result;
+}
+
+static std::vector<std::uint8_t> from_hex(std::string_view hex)
+{
+    std::vector<std::uint8_t> result;
+    for (std::size_t i = 0; i + 1 < hex.size(); i += 2)
+    {
+        auto digit = [](char ch) { return (ch <= '9') ? (ch - '0') : (ch - 'a' + 10); };
+        result.push_back(static_cast<std::uint8_t>((digit(hex[i]) << 4) | digit(hex[i + 1])));
+    }
+
+    return result;
+}
+
+static int cbor_encode_test()
+{
+    test_guard guard{ "cbor_encode_test" };
+
+    // Examples from RFC 8949, Appendix A
+    std::pair<json::value, std::string_view> tests[] = {
+        { 0.0, "00" },
+        { 23.0, "17" },
+        { 24.0, "1818" },
+        { 1000.0, "1903e8" },
+        { 1000000.0, "1a000f4240" },
+        { 1000000000000.0, "1b000000e8d4a51000" },
+        { -1.0, "20" },
+        { -1000.0, "3903e7" },
+        { 1.5, "fb3ff8000000000000" },
+        { -0.0, "fb8000000000000000" },
+        { 1.0e300, "fb7e37e43c8800759c" },
+        { false, "f4" },
+        { true, "f5" },
+        { nullptr, "f6" },
+        { json::value(), "f7" },
+        { ""s, "60" },
+        { "IETF"s, "6449455446" },
+        { "ü"s, "62c3bc" },
+        { json::array{}, "80" },
+        { json::array{ 1.0, json::array{ 2.0, 3.0 } }, "8201820203" },
+        { json::object{ { "a", 1.0 } }, "a1616101" },
+        { json::number::from_text("18446744073709551615"), "1bffffffffffffffff" },
+        { json::number::from_text("-9223372036854775808"), "3b7fffffffffffffff" },
+        { json::number::from_text("1e2"), "1864" },
+    };
+
+    for (auto& [value, expected] : tests)
+    {
+        auto encoded = json::cbor_encode(value);
+        auto actual = encoded ? to_hex(*encoded) : "<failed>"s;
+        if (actual != expected)
+        {
+            std::printf("ERROR: Expected encoding '%s', got '%s'\n", expected.data(), actual.c_str());
+            return 1;
+        }
+    }
+
+    // Numbers out of range for a 'double' have no exact encoding
+    std::vector<std::uint8_t> prefixed = { 0xAB };
+    for (auto text : { "1e400"sv, "-1e400"sv, "123456789012345678901234567890e300"sv })
+    {
+        if (json::cbor_encode(json::array{ 1.0, json::number::from_text(text) }) ||
+            json::cbor_encode(json::number::from_text(text), prefixed) || (prefixed.size() != 1))
+        {
+            std::printf("ERROR: Expected encoding of '%s' to fail\n", text.data());
+            return 1;
+        }
+    }
+
+    return guard.success();
+}
+
+static int cbor_decode_test()
+{
+    test_guard guard{ "cbor_decode_test" };
+
+    std::pair<std::string_view, json::value> tests[] = {
+        { "1b000000e8d4a51000", 1000000000000.0 },
+        { "1bffffffffffffffff", json::number::from_text("18446744073709551615") },
+        { "3b7fffffffffffffff", json::number::from_text("-9223372036854775808") },
+        { "3bffffffffffffffff", -18446744073709551616.0 },
+        { "f93c00", 1.0 },
+        { "f9c400", -4.0 },
+        { "f90001", 5.960464477539063e-8 },
+        { "fa47c35000", 100000.0 },
+        { "c074323031332d30332d32315432303a30343a30305a", "2013-03-21T20:04:00Z"s }, // Tags are ignored
+        { "a26161016162820203", json::object{ { "a", 1.0 }, { "b", json::array{ 2.0, 3.0 } } } },
+    };
+
+    for (auto& [hex, expected] : tests)
+    {
+        json::value value;
+        if (!json::cbor_decode(from_hex(hex), value) || (value != expected))
+        {
+            std::printf("ERROR: Incorrect decoding of '%s'\n", hex.data());
+            return 1;
+        }
+    }
+
+    for (auto hex : { ""sv, "19"sv, "1903"sv, "0000"sv, "6449455"sv, "4449455446"sv, "9f01ff"sv, "a1010203"sv,
+             "a2616101616102"sv, "f97e00"sv, "fa7f800000"sv, "fb7ff8000000000000"sv, "f820"sv, "9bffffffffffffffff"sv,
+             "83010203"sv.substr(0, 6) })
+    {
+        json::value value;
+        if (json::cbor_decode(from_hex(hex), value))
+        {
+            std::printf("ERROR: Expected decoding of '%s' to fail\n", std::string(hex).c_str());
+            return 1;
+        }
+    }
+
+    // Untrusted input must not be able to recurse without bound
+    std::vector<std::uint8_t> tagged(100000, 0xC0);
+    tagged.push_back(0x01);
+    json::value value;
+    if (!json::cbor_decode(tagged, value) || (value != json::value(1.0)))
+    {
+        std::printf("ERROR: Failed to decode a long chain of tags\n");
+        return 1;
+    }
+
+    auto nested = [](std::size_t depth, std::vector<std::uint8_t> prefix) {
+        std::vector<std::uint8_t> result;
+        for (std::size_t i = 0; i < depth; ++i) result.insert(result.end(), prefix.begin(), prefix.end());
+        result.push_back(0x01);
+        return result;
+    };
+
+    if (!json::cbor_decode(nested(json::cbor_max_depth - 1, { 0x81 }), value) ||
+        !json::cbor_decode(nested(json::cbor_max_depth - 1, { 0xA1, 0x61, 0x61 }), value) ||
+        json::cbor_decode(nested(json::cbor_max_depth, { 0x81 }), value) ||
+        json::cbor_decode(nested(100000, { 0x81 }), value) ||
+        json::cbor_decode(nested(100000, { 0xA1, 0x61, 0x61 }), value))
+    {
+        std::printf("ERROR: Incorrect handling of deeply nested input\n");
+        return 1;
+    }
+
+    return guard.success();
+}
+
+static int cbor_round_trip_test()
+{
+    test_guard guard{ "cbor_round_trip_test" };
+
+    auto value = parse(R"^-^({
+        "null": null,
+        "true": true,
+        "false": false,
+        "integers": [ 0, 1, -1, 23, 24, 255, 256, 65535, 65536, 4294967295, 4294967296, 9007199254740992 ],
+        "floats": [ 0.5, -0.25, 3.141592653589793, 1e-300, -1.7976931348623157e308 ],
+        "strings": [ "", "foo", "é中😀", "a string that is longer than twenty three bytes" ],
+        "nested": { "a": [ [ [] ], {} ], "b": { "c": { "d": "e" } } }
+    })^-^");
+
+    auto bytes = json::cbor_encode(value);
+    json::value decoded;
+    if (!bytes || !json::cbor_decode(*bytes, decoded) || (decoded != value))
+    {
+        std::printf("ERROR: Value did not round trip\n");
+        return 1;
+    }
+
+    // Appending to an existing buffer
+    std::vector<std::uint8_t> prefixed = { 0xAB };
+    if (!json::cbor_encode(value, prefixed) || !json::cbor_decode(std::span(prefixed).subspan(1), decoded) ||
+        (decoded != value))
+    {
+        std::printf("ERROR: Value did not round trip after a prefix\n");
+        return 1;
+    }
+
+    return guard.success();
+}
+
+int cbor_tests()
+{
+    int result = 0;
+    result += cbor_encode_test();
+    result += cbor_decode_test();
+    result += cbor_round_trip_test();
+    return result;
+}
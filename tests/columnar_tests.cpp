@@ -0,0 +1,216 @@
+
+#include <json_columnar.h>
+#include <sstream>
+
+#include "test_guard.h"
+
+using namespace std::literals;
+
+template <typename Callback>
+static bool run_with_lexer(const std::string& str, Callback&& callback)
+{
+    json::buffer_input_stream bufferStream(str.data(), str.data() + str.size());
+    json::lexer bufferLexer(bufferStream);
+    if (!callback(bufferLexer)) return false;
+
+    std::stringstream sstream(str);
+    json::istream istream(sstream);
+    json::lexer istreamLexer(istream);
+    if (!callback(istreamLexer)) return false;
+
+    return true;
+}
+
+static int columnar_reader_test()
+{
+    test_guard guard{ "columnar_reader_test" };
+
+    auto input = R"^-^([
+        { "ts": 1000, "v": 1.5, "tag": "a", "ok": true },
+        { "v": -2, "ts": 1001, "extra": { "nested": [ 1, 2 ] }, "ok": false },
+        { "ts": 1002, "v": null, "tag": "ccc", "ok": null },
+        { "tag": "", "ts": 9007199254740993 }
+    ])^-^"s;
+
+    auto success = run_with_lexer(input, [](auto& lexer) {
+        json::columnar_reader reader;
+        auto ts = reader.add_column("ts", json::column_type::integer);
+        auto v = reader.add_column("v", json::column_type::number);
+        auto tag = reader.add_column("tag", json::column_type::string);
+        auto ok = reader.add_column("ok", json::column_type::boolean);
+        if ((reader.add_column("v", json::column_type::number) != v) || (reader.column_count() != 4))
+        {
+            std::printf("ERROR: Expected adding an existing column to return its index\n");
+            return false;
+        }
+
+        if ((reader.add_column("v", json::column_type::string) != json::columnar_reader::npos) ||
+            (reader.column_count() != 4))
+        {
+            std::printf("ERROR: Expected adding an existing column with a different type to fail\n");
+            return false;
+        }
+
+        if (!reader.read(lexer) || (lexer.current_token != json::lexer_token::eof) || (reader.row_count() != 4))
+        {
+            std::printf("ERROR: Failed to read columns\n");
+            return false;
+        }
+
+        auto& tsColumn = reader[ts];
+        auto& vColumn = reader[v];
+        auto& tagColumn = reader[tag];
+        auto& okColumn = reader[ok];
+        if ((tsColumn.integers().size() != 4) || (tsColumn.integers()[0] != 1000) || (tsColumn.integers()[1] != 1001) ||
+            (tsColumn.integers()[3] != 9007199254740993) || (tsColumn.null_count() != 0) || !tsColumn.numbers().empty())
+        {
+            std::printf("ERROR: Incorrect integer column\n");
+            return false;
+        }
+
+        if ((vColumn.numbers().size() != 4) || (vColumn.numbers()[0] != 1.5) || (vColumn.numbers()[1] != -2) ||
+            !vColumn.is_valid(1) || vColumn.is_valid(2) || vColumn.is_valid(3) || (vColumn.null_count() != 2) ||
+            (vColumn.validity()[0] != 0b0011))
+        {
+            std::printf("ERROR: Incorrect number column\n");
+            return false;
+        }
+
+        if ((tagColumn.string(0) != "a") || (tagColumn.string(1) != "") || tagColumn.is_valid(1) ||
+            (tagColumn.string(2) != "ccc") || (tagColumn.string(3) != "") || !tagColumn.is_valid(3) ||
+            (tagColumn.string_bytes() != "accc") || (tagColumn.string_offsets().size() != 5))
+        {
+            std::printf("ERROR: Incorrect string column\n");
+            return false;
+        }
+
+        if ((okColumn.booleans()[0] != 1) || (okColumn.booleans()[1] != 0) || !okColumn.is_valid(1) ||
+            okColumn.is_valid(2) || okColumn.is_valid(3) || (reader.find("ok") != &okColumn) || reader.find("extra"))
+        {
+            std::printf("ERROR: Incorrect boolean column\n");
+            return false;
+        }
+
+        return true;
+    });
+
+    return success ? guard.success() : 1;
+}
+
+static int columnar_reader_failure_test()
+{
+    test_guard guard{ "columnar_reader_failure_test" };
+
+    auto make_reader = [] {
+        json::columnar_reader reader;
+        reader.add_column("i", json::column_type::integer);
+        reader.add_column("s", json::column_type::string);
+        return reader;
+    };
+
+    for (auto input : { R"([{ "i": 1.5 }])"sv, R"([{ "i": "1" }])"sv, R"([{ "s": 1 }])"sv, R"([{ "i": 1, "i": 2 }])"sv,
+             R"([1])"sv, R"({ "i": 1 })"sv, R"([{ "i": 1 },])"sv, R"([{ "i": 1 })"sv })
+    {
+        auto success = run_with_lexer(std::string(input), [&](auto& lexer) {
+            auto reader = make_reader();
+            if (reader.read(lexer))
+            {
+                std::printf("ERROR: Expected reading '%s' to fail\n", input.data());
+                return false;
+            }
+
+            return true;
+        });
+        if (!success) return 1;
+    }
+
+    // Rows from a failed array are discarded, and rows from earlier arrays are kept
+    auto input = R"([{ "i": 1, "s": "x" }, { "i": 2 }] [{ "i": 3, "s": "y" }, { "i": "bad" }] [{ "s": "z" }])"s;
+    auto success = run_with_lexer(input, [&](auto& lexer) {
+        auto reader = make_reader();
+        if (!reader.read(lexer) || reader.read(lexer))
+        {
+            std::printf("ERROR: Unexpected result reading arrays\n");
+            return false;
+        }
+
+        auto& i = reader[0];
+        auto& s = reader[1];
+        if ((reader.row_count() != 2) || (i.size() != 2) || (i.integers().size() != 2) || (s.size() != 2) ||
+            (s.string_bytes() != "x") || (s.null_count() != 1) || (s.string_offsets().size() != 3))
+        {
+            std::printf("ERROR: Expected rows from the failed array to be discarded\n");
+            return false;
+        }
+
+        // Columns added later are null for existing rows
+        auto added = reader.add_column("n", json::column_type::number);
+        if ((reader[added].size() != 2) || (reader[added].null_count() != 2))
+        {
+            std::printf("ERROR: Expected new column to be padded with nulls\n");
+            return false;
+        }
+
+        reader.clear();
+        if ((reader.row_count() != 0) || (reader[0].size() != 0) || !reader[1].string_bytes().empty() ||
+            (reader[1].null_count() != 0))
+        {
+            std::printf("ERROR: Expected 'clear' to remove all rows\n");
+            return false;
+        }
+
+        return true;
+    });
+
+    return success ? guard.success() : 1;
+}
+
+static int columnar_reader_large_test()
+{
+    test_guard guard{ "columnar_reader_large_test" };
+
+    std::string input = "[";
+    for (int i = 0; i < 1000; ++i)
+    {
+        if (i) input += ",";
+        input += "{\"id\":" + std::to_string(i);
+        if (i % 3) input += ",\"name\":\"n" + std::to_string(i) + "\"";
+        input += "}";
+    }
+    input += "]";
+
+    auto success = run_with_lexer(input, [](auto& lexer) {
+        json::columnar_reader reader;
+        reader.add_column("id", json::column_type::integer);
+        reader.add_column("name", json::column_type::string);
+        if (!reader.read(lexer) || (reader.row_count() != 1000))
+        {
+            std::printf("ERROR: Failed to read large array\n");
+            return false;
+        }
+
+        for (std::size_t i = 0; i < 1000; ++i)
+        {
+            auto expectName = (i % 3) ? "n" + std::to_string(i) : ""s;
+            if ((reader[0].integers()[i] != static_cast<std::int64_t>(i)) || (reader[1].string(i) != expectName) ||
+                (reader[1].is_valid(i) != ((i % 3) != 0)))
+            {
+                std::printf("ERROR: Incorrect value in row %zu\n", i);
+                return false;
+            }
+        }
+
+        return true;
+    });
+
+    return success ? guard.success() : 1;
+}
+
+int columnar_tests()
+{
+    int result = 0;
+    result += columnar_reader_test();
+    result += columnar_reader_failure_test();
+    result += columnar_reader_large_test();
+    return result;
+}
@@ -0,0 +1,168 @@
+
+#include <json_cursor.h>
+#include <sstream>
+
+#include "test_guard.h"
+
+using namespace std::literals;
+
+template <typename Callback>
+static bool run_with_lexer(const std::string& str, Callback&& callback)
+{
+    json::buffer_input_stream bufferStream(str.data(), str.data() + str.size());
+    json::lexer bufferLexer(bufferStream);
+    if (!callback(bufferLexer)) return false;
+
+    std::stringstream sstream(str);
+    json::istream istream(sstream);
+    json::lexer istreamLexer(istream);
+    if (!callback(istreamLexer)) return false;
+
+    return true;
+}
+
+static const std::string test_document = R"^-^({
+    "skipped": { "id": 0, "nested": [ 1, [ 2, 3 ], { "id": 4 } ] },
+    "user": { "id": 42, "big": 9223372036854775807, "name": "foo", "admin": false },
+    "tags": [ "a", "b", "c" ],
+    "counts": { "x": 1, "y": 2 },
+    "extra": null
+})^-^";
+
+static int cursor_lookup_test()
+{
+    test_guard guard{ "cursor_lookup_test" };
+
+    if (!run_with_lexer(test_document, [](auto& lexer) {
+            json::document_cursor doc(lexer);
+            auto id = doc["user"]["id"].template get<std::int64_t>();
+            auto big = doc["user"]["big"].template get<std::int64_t>();
+            auto name = doc["user"]["name"].template get<std::string_view>();
+            if (!id || (*id != 42) || !big || (*big != 9223372036854775807ll) || !name || (*name != "foo"))
+            {
+                std::printf("ERROR: Incorrect member values\n");
+                return false;
+            }
+
+            // Skipping 'admin' and 'tags'
+            if (doc["tags"][1].template get<std::string>() != "b"s)
+            {
+                std::printf("ERROR: Incorrect array element\n");
+                return false;
+            }
+
+            auto counts = doc["counts"].template get<json::value>();
+            if (!counts || !counts->get_object() || (counts->get_object()->size() != 2))
+            {
+                std::printf("ERROR: Failed to read value\n");
+                return false;
+            }
+
+            if (!doc["extra"].template get<std::nullptr_t>() || !doc)
+            {
+                std::printf("ERROR: Failed to read null\n");
+                return false;
+            }
+
+            return doc.finish() && (lexer.current_token == json::lexer_token::eof);
+        }))
+        return 1;
+
+    return guard.success();
+}
+
+static int cursor_iteration_test()
+{
+    test_guard guard{ "cursor_iteration_test" };
+
+    if (!run_with_lexer(test_document, [](auto& lexer) {
+            json::document_cursor doc(lexer);
+            std::string keys;
+            for (auto [key, value] : doc.members())
+            {
+                keys += key;
+                keys += ';';
+                if (key == "tags")
+                {
+                    std::string tags;
+                    for (auto tag : value) tags += *tag.template get<std::string_view>();
+                    if (tags != "abc")
+                    {
+                        std::printf("ERROR: Incorrect array iteration\n");
+                        return false;
+                    }
+                }
+                else if (key == "counts")
+                {
+                    // Only visit the first member; the rest should get skipped
+                    for (auto member : value.members())
+                    {
+                        if ((member.key != "x") || (member.value.template get<int>() != 1)) return false;
+                        break;
+                    }
+                }
+            }
+
+            if (keys != "skipped;user;tags;counts;extra;")
+            {
+                std::printf("ERROR: Incorrect object iteration: '%s'\n", keys.c_str());
+                return false;
+            }
+
+            return !!doc && (lexer.current_token == json::lexer_token::eof);
+        }))
+        return 1;
+
+    return guard.success();
+}
+
+static int cursor_forward_only_test()
+{
+    test_guard guard{ "cursor_forward_only_test" };
+
+    if (!run_with_lexer(test_document, [](auto& lexer) {
+            json::document_cursor doc(lexer);
+            auto user = doc["user"];
+            auto name = user["name"];
+            if (!name.template get<std::string_view>() || user["id"])
+            {
+                std::printf("ERROR: Expected to only be able to read values in order\n");
+                return false;
+            }
+
+            // Type mismatches do not consume the value
+            auto tags = doc["tags"];
+            if (tags["foo"] || tags.template get<int>() || !tags[2])
+            {
+                std::printf("ERROR: Expected type mismatches to fail\n");
+                return false;
+            }
+
+            // Cursors to values that have been moved past are no longer valid
+            if (user.type() != json::lexer_token::invalid || name.template get<std::string_view>() || doc["user"])
+            {
+                std::printf("ERROR: Expected stale cursors to fail\n");
+                return false;
+            }
+
+            return true;
+        }))
+        return 1;
+
+    if (!run_with_lexer(R"^-^({ "a": [ 1, 2 }, "b": 42 })^-^", [](auto& lexer) {
+            json::document_cursor doc(lexer);
+            return !doc["b"] && !doc;
+        }))
+        return 1;
+
+    return guard.success();
+}
+
+int cursor_tests()
+{
+    int result = 0;
+    result += cursor_lookup_test();
+    result += cursor_iteration_test();
+    result += cursor_forward_only_test();
+    return result;
+}
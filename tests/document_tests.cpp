@@ -0,0 +1,275 @@
+
+#include <atomic>
+#include <cstdio>
+#include <json_document.h>
+#include <thread>
+#include <vector>
+
+#include "test_guard.h"
+
+using namespace std::literals;
+
+static int shared_document_test()
+{
+    test_guard guard{ "shared_document_test" };
+
+    json::shared_document doc;
+    auto initial = doc.load();
+    if (!initial || (initial->data.index() != 0) || (doc.version() != 0))
+    {
+        std::printf("ERROR: Expected an empty initial document\n");
+        return 1;
+    }
+
+    if (!doc.reload(R"({ "name": "foo" })"sv) || (doc.version() != 1))
+    {
+        std::printf("ERROR: Failed to reload document\n");
+        return 1;
+    }
+
+    auto first = doc.load();
+    auto name = json::object_get_as<json::string>(*first->get_object(), "name");
+    if (!name || (*name != "foo"))
+    {
+        std::printf("ERROR: Incorrect reloaded value\n");
+        return 1;
+    }
+
+    for (auto invalid : { ""sv, "{"sv, "[ 1, 2 ] 3"sv, R"({ "a": 1, "a": 2 })"sv })
+    {
+        if (doc.reload(invalid) || (doc.load() != first) || (doc.version() != 1))
+        {
+            std::printf("ERROR: Expected invalid input to keep the current version\n");
+            return 1;
+        }
+    }
+
+    doc.publish(json::value(42.0));
+    if ((doc.version() != 2) || (*doc.load() != json::value(42.0)) ||
+        (*first->get_object()->at("name").get_string() != "foo"))
+    {
+        std::printf("ERROR: Expected publish to replace the document without affecting readers\n");
+        return 1;
+    }
+
+    doc.publish(std::shared_ptr<const json::value>());
+    if ((doc.version() != 2) || !doc.load())
+    {
+        std::printf("ERROR: Expected publishing null to be ignored\n");
+        return 1;
+    }
+
+    // Reloading while parsing another document with 'thread_lexer' must not disturb the outer parse
+    auto outer = R"([ "[ 1 ]", "{ \"b\": 2 }" ])"s;
+    json::buffer_input_stream<char> stream(outer);
+    auto& lexer = json::thread_lexer(stream);
+    auto success = json::parse_array(lexer, doc, [](auto& lexer, json::shared_document& doc) {
+        if ((lexer.current_token != json::lexer_token::string) || !doc.reload(lexer.string_value)) return false;
+        lexer.advance();
+        return true;
+    });
+
+    if (!success || (lexer.current_token != json::lexer_token::eof) || !doc.load()->get_object() ||
+        (doc.version() != 4))
+    {
+        std::printf("ERROR: Reload interfered with the enclosing parse\n");
+        return 1;
+    }
+
+    return guard.success();
+}
+
+static int shared_document_threading_test()
+{
+    test_guard guard{ "shared_document_threading_test" };
+
+    // Each version holds two copies of the same counter; readers must never observe a torn or partial version
+    auto makeText = [](int counter) {
+        auto str = std::to_string(counter);
+        return R"({ "a": )" + str + R"(, "list": [ 1, 2, 3 ], "b": )" + str + " }";
+    };
+
+    json::shared_document doc(json::value(json::object{ { "a", 0.0 }, { "b", 0.0 } }));
+    constexpr int reloadCount = 1000;
+    std::atomic<bool> done = false;
+    std::atomic<int> failures = 0;
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; ++i)
+    {
+        readers.emplace_back([&] {
+            double previous = 0;
+            while (!done.load(std::memory_order_acquire))
+            {
+                auto snapshot = doc.load();
+                auto& obj = *snapshot->get_object();
+                auto a = json::object_get_as<json::number>(obj, "a")->get<double>();
+                auto b = json::object_get_as<json::number>(obj, "b")->get<double>();
+                if ((a != b) || (*a < previous)) ++failures;
+                previous = *a;
+            }
+        });
+    }
+
+    for (int i = 1; i <= reloadCount; ++i)
+    {
+        if (!doc.reload(makeText(i))) ++failures;
+    }
+
+    done.store(true, std::memory_order_release);
+    for (auto& thread : readers) thread.join();
+
+    if ((failures != 0) || (doc.version() != reloadCount))
+    {
+        std::printf("ERROR: Readers observed an inconsistent document\n");
+        return 1;
+    }
+
+    return guard.success();
+}
+
+static json::value parse(std::string_view text, bool* valid = nullptr)
+{
+    json::buffer_input_stream<char> stream(text);
+    json::lexer lexer(stream);
+    json::value result;
+    auto success = json::parse_value(lexer, result) && (lexer.current_token == json::lexer_token::eof);
+    if (valid) *valid = success;
+    return result;
+}
+
+// Compares an incremental document against a full parse of its text, and checks that the span of every value holds
+// exactly that value
+static bool check_document(const json::incremental_document& doc)
+{
+    bool valid;
+    auto expected = parse(doc.text(), &valid);
+    if (valid != doc.valid()) return false;
+    if (!valid) return doc.root().data.index() == 0;
+    if (doc.root() != expected) return false;
+
+    for (std::size_t i = 0; i < doc.text().size(); ++i)
+    {
+        json::text_span span;
+        auto val = doc.find(i, &span);
+        if (!val) continue;
+        if ((i < span.begin) || (i >= span.end)) return false;
+        if (parse(std::string_view(doc.text()).substr(span.begin, span.size())) != *val) return false;
+    }
+
+    return true;
+}
+
+static int incremental_document_test()
+{
+    test_guard guard{ "incremental_document_test" };
+
+    json::incremental_document doc(R"({
+    "name": "config",
+    "values": [ 1, 2, 3 ],
+    "nested": { "enabled": true, "items": [ { "id": 1 }, { "id": 2 } ] },
+    "last": null
+})");
+    if (!doc.valid() || !check_document(doc))
+    {
+        std::printf("ERROR: Incorrect initial document\n");
+        return 1;
+    }
+
+    // Each edit replaces text at the first occurrence of 'find' (plus 'offset') and should reparse exactly 'expected',
+    // or the whole text if it is empty
+    auto edit = [&](std::string_view find, std::size_t offset, std::size_t length, std::string_view replacement,
+                    std::string_view expected) {
+        auto position = doc.text().find(find) + offset;
+        auto success = doc.replace(position, length, replacement);
+        auto reparsed = std::string_view(doc.text()).substr(doc.last_reparsed().begin, doc.last_reparsed().size());
+        if (success != doc.valid() || !check_document(doc))
+        {
+            std::printf("ERROR: Document does not match its text after replacing \"%.*s\"\n", int(find.size()),
+                find.data());
+            return false;
+        }
+        else if (reparsed != (expected.empty() ? std::string_view(doc.text()) : expected))
+        {
+            std::printf("ERROR: Expected edit to reparse \"%.*s\", but reparsed \"%.*s\"\n", int(expected.size()),
+                expected.data(), int(reparsed.size()), reparsed.data());
+            return false;
+        }
+
+        return true;
+    };
+
+    auto success = edit("2,", 0, 1, "200", "200") && // A scalar grows; later values must shift
+        edit("true", 0, 4, "false", "false") && edit("\"config\"", 3, 0, "ur", "\"cournfig\"") &&
+        edit("3 ]", 1, 0, ", 4", "[ 1, 200, 3, 4 ]") && // Not a single value; falls back to the array
+        edit("{ \"id\": 2 }", 8, 1, "[ 5, 6 ]", "[ 5, 6 ]") && // A scalar becomes an array
+        edit("5, 6", 3, 1, "  7", "7") && // Leading whitespace is not part of the value
+        edit("{ \"id\": 1 }, ", 0, 13, "", R"([ { "id": [ 5,   7 ] } ])") && // Removing an element
+        edit("values", 0, 6, "numbers", "") && // Keys belong to the enclosing object
+        edit("null", 0, 4, "nul", ""); // Invalid; the whole document is reparsed
+    if (!success) return 1;
+
+    if (doc.valid() || doc.find(0))
+    {
+        std::printf("ERROR: Expected invalid edit to invalidate the document\n");
+        return 1;
+    }
+
+    if (!edit("nul", 3, 0, "l", "") || !doc.valid())
+    {
+        std::printf("ERROR: Expected document to be valid again after fixing it\n");
+        return 1;
+    }
+
+    auto text = doc.text();
+    if (doc.replace(text.size() + 1, 0, "x") || doc.replace(text.size(), 1, "") || (doc.text() != text))
+    {
+        std::printf("ERROR: Expected out of range edits to be rejected\n");
+        return 1;
+    }
+
+    return guard.success();
+}
+
+static int incremental_document_sequence_test()
+{
+    test_guard guard{ "incremental_document_sequence_test" };
+
+    // Applies a deterministic sequence of edits at varying positions, many of which are invalid, and checks the
+    // document against a full parse after every one
+    json::incremental_document doc(R"([ { "a": 1, "b": [ true, "x" ] }, 2.5, [ [], {} ], "y", null ])");
+    std::string_view replacements[] = { "", "1", " ", ",", "\"", "[", "]", "{}", "[0]", "\"s\"", "9e9", "null" };
+    std::uint32_t state = 12345;
+    for (int i = 0; i < 2000; ++i)
+    {
+        state = state * 1103515245 + 12345;
+        auto position = (state >> 8) % (doc.text().size() + 1);
+        auto length = std::min<std::size_t>((state >> 4) % 3, doc.text().size() - position);
+        auto& replacement = replacements[(state >> 16) % std::size(replacements)];
+
+        doc.replace(position, length, replacement);
+        if (!check_document(doc))
+        {
+            std::printf("ERROR: Document does not match its text after edit %d: %s\n", i, doc.text().c_str());
+            return 1;
+        }
+
+        // Keep the document small, and bring it back to a valid state every so often
+        if ((doc.text().size() > 200) || (i % 50 == 49))
+        {
+            doc.replace(0, doc.text().size(), R"([ { "a": 1, "b": [ true, "x" ] }, 2.5, [ [], {} ], "y", null ])");
+        }
+    }
+
+    return guard.success();
+}
+
+int document_tests()
+{
+    int result = 0;
+    result += shared_document_test();
+    result += shared_document_threading_test();
+    result += incremental_document_test();
+    result += incremental_document_sequence_test();
+    return result;
+}
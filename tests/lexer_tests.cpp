@@ -1,4 +1,5 @@
 
+#include <cstdio>
 #include <json_lexer.h>
 #include <sstream>
 
@@ -104,6 +105,10 @@ static bool test_lex_expect_single_invalid(const std::basic_string<CharT>& str)
     return test_lex_expect_single_token(str, json::lexer_token::invalid, ""sv);
 }
 
+static_assert(json::ContiguousInputStream<json::buffer_input_stream<char>>);
+static_assert(json::ContiguousInputStream<json::buffer_input_stream<char8_t>>);
+static_assert(!json::ContiguousInputStream<json::istream<char>>);
+
 static int lex_null_test()
 {
     test_guard guard{ "lex_null_test" };
@@ -258,6 +263,9 @@ static int lex_valid_string_test()
     if (!do_test(u8"I \u2665 unicode", u8"I \u2665 unicode")) return 1;
     if (!do_test(u8"\\uaBcD", u8"\uabcd")) return 1;
     if (!do_test(u8"\\\"\\\\\\/\\b\\f\\n\\r\\t", u8"\"\\/\b\f\n\r\t")) return 1;
+    if (!do_test(u8"\\ud83d\\ude00", u8"\U0001F600")) return 1;
+    if (!do_test(u8"\\uD800\\uDC00\\uDBFF\\uDFFF", u8"\U00010000\U0010FFFF")) return 1;
+    if (!do_test(u8"a\\u00e9b\\u00E9\\u0041", u8"a\u00e9b\u00e9A")) return 1;
 
     return guard.success();
 }
@@ -275,8 +283,114 @@ static int lex_invalid_string_test()
     if (!test_lex_expect_single_invalid("\"\\u266\""s)) return 1;
     if (!test_lex_expect_single_invalid("\"\\u266G\""s)) return 1;
     if (!test_lex_expect_single_invalid("\"\\x42\""s)) return 1;
+    if (!test_lex_expect_single_invalid("\"\\ud83d\""s)) return 1; // Lone high surrogate
+    if (!test_lex_expect_single_invalid("\"\\ude00\""s)) return 1; // Lone low surrogate
+    if (!test_lex_expect_single_invalid("\"\\ud83d\\u0041\""s)) return 1; // High surrogate followed by non-surrogate
+    if (!test_lex_expect_single_invalid("\"\\ud83d\\ud83d\""s)) return 1; // Two high surrogates
+    if (!test_lex_expect_single_invalid("\"\\ud83dx\\ude00\""s)) return 1; // Not adjacent
+    if (!test_lex_expect_single_invalid("\"\\ud83d\\ude0"s)) return 1; // Truncated
     if (!test_lex_expect_single_invalid("\"\\q\""s)) return 1;
     if (!test_lex_expect_single_invalid("\"\v\""s)) return 1;
+    if (!test_lex_expect_single_invalid("\"foo\xFF" "bar\""s)) return 1;
+    if (!test_lex_expect_single_invalid("\"foo\\"s)) return 1;
+
+    return guard.success();
+}
+
+static int lex_padded_buffer_test()
+{
+    test_guard guard{ "lex_padded_buffer_test" };
+
+    // Place special characters at every offset to exercise both whole-word and per-character scanning
+    for (std::size_t i = 0; i < 24; ++i)
+    {
+        auto padding = std::string(i, ' ');
+        auto text = std::string(i, 'a');
+        auto input = padding + "\"" + text + "\\n" + text + "\"" + padding;
+        auto expected = text + "\n" + text;
+
+        json::padded_string buffer(input);
+        json::buffer_input_stream stream(buffer);
+        json::lexer lexer(stream);
+        if (!test_lex_expect_single_token(lexer, json::lexer_token::string, std::string_view(expected))) return 1;
+        if (!test_lex_expect_single_token(input, json::lexer_token::string, std::string_view(expected))) return 1;
+
+        // Unterminated strings must not read past the end of the buffer
+        buffer = json::padded_string(std::string_view(input).substr(0, i + 1 + i));
+        json::buffer_input_stream truncatedStream(buffer);
+        json::lexer truncatedLexer(truncatedStream);
+        if (!test_lex_expect_single_token(truncatedLexer, json::lexer_token::invalid, ""sv)) return 1;
+    }
+
+    const char* path = "lex_padded_buffer_test.json";
+    auto contents = R"^-^({ "foo": [ 42, "bar" ] })^-^"sv;
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << contents;
+    }
+
+    json::padded_string buffer;
+    auto result = json::read_file(path, buffer);
+    std::remove(path);
+    if (!result || (std::string_view(buffer.data(), buffer.size()) != contents) ||
+        (buffer.data()[buffer.size()] != '\0'))
+    {
+        std::printf("ERROR: Failed to read file\n");
+        return 1;
+    }
+
+    json::buffer_input_stream stream(buffer);
+    json::lexer lexer(stream);
+    if (!test_lex_expect_tokens<char>(lexer,
+            { { json::lexer_token::curly_open, "{"sv }, { json::lexer_token::string, "foo"sv },
+                { json::lexer_token::colon, ":"sv }, { json::lexer_token::bracket_open, "["sv },
+                { json::lexer_token::number, "42"sv }, { json::lexer_token::comma, ","sv },
+                { json::lexer_token::string, "bar"sv }, { json::lexer_token::bracket_close, "]"sv },
+                { json::lexer_token::curly_close, "}"sv } }))
+        return 1;
+
+    return guard.success();
+}
+
+static int lex_reset_test()
+{
+    test_guard guard{ "lex_reset_test" };
+
+    auto first = "\"" + std::string(100, 'a') + "\""s;
+    json::buffer_input_stream<char> firstStream(first);
+    json::lexer lexer(firstStream);
+    if (!test_lex_expect_single_token(lexer, json::lexer_token::string, std::string_view(first).substr(1, 100)))
+        return 1;
+
+    // Errors are cleared and buffers are retained
+    auto capacity = lexer.string_value.capacity();
+    auto second = "[ 42, invalid ]"s;
+    json::buffer_input_stream<char> secondStream(second);
+    lexer.reset(secondStream);
+    if (!test_lex_expect_tokens<char>(lexer,
+            { { json::lexer_token::bracket_open, "["sv }, { json::lexer_token::number, "42"sv },
+                { json::lexer_token::comma, ","sv }, { json::lexer_token::invalid, ""sv } }))
+        return 1;
+
+    auto third = "null"s;
+    json::buffer_input_stream<char> thirdStream(third);
+    lexer.reset(thirdStream);
+    if (lexer.string_value.capacity() < capacity)
+    {
+        std::printf("ERROR: Lexer did not retain its buffer\n");
+        return 1;
+    }
+    if (!test_lex_expect_single_token(lexer, json::lexer_token::keyword_null, "null"sv)) return 1;
+
+    // The thread-local lexer is reused between calls
+    json::buffer_input_stream<char> fourthStream(third);
+    auto& threadLexer = json::thread_lexer(secondStream);
+    if ((&json::thread_lexer(fourthStream) != &threadLexer) ||
+        (threadLexer.current_token != json::lexer_token::keyword_null))
+    {
+        std::printf("ERROR: Thread-local lexer not reused\n");
+        return 1;
+    }
 
     return guard.success();
 }
@@ -345,6 +459,8 @@ int lexer_tests()
     result += lex_invalid_text_test();
     result += lex_valid_string_test();
     result += lex_invalid_string_test();
+    result += lex_padded_buffer_test();
+    result += lex_reset_test();
     result += lex_array_test();
     result += lex_object_test();
     return result;
@@ -5,6 +5,20 @@ int unicode_tests();
 int lexer_tests();
 int parser_tests();
 int value_tests();
+int projection_tests();
+int cursor_tests();
+int shared_value_tests();
+int memory_tests();
+int cache_tests();
+int schema_tests();
+int sax_tests();
+int batch_tests();
+int block_stream_tests();
+int cbor_tests();
+int snapshot_tests();
+int columnar_tests();
+int document_tests();
+int minify_tests();
 
 int main()
 {
@@ -13,5 +27,19 @@ int main()
     result += lexer_tests();
     result += parser_tests();
     result += value_tests();
+    result += projection_tests();
+    result += cursor_tests();
+    result += shared_value_tests();
+    result += memory_tests();
+    result += cache_tests();
+    result += schema_tests();
+    result += sax_tests();
+    result += batch_tests();
+    result += block_stream_tests();
+    result += cbor_tests();
+    result += snapshot_tests();
+    result += columnar_tests();
+    result += document_tests();
+    result += minify_tests();
     return result;
 }
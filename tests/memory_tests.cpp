@@ -0,0 +1,131 @@
+
+#include <cstdlib>
+#include <json.h>
+#include <new>
+#include <optional>
+
+#include "test_guard.h"
+
+using namespace std::literals;
+
+// Counting allocator: while 'counting_allocations' is set, all global allocations are tallied
+static bool counting_allocations = false;
+static std::size_t allocated_bytes = 0;
+
+#if defined(__GNUC__) && !defined(__clang__)
+// GCC does not recognize that 'operator delete' is paired with the 'operator new' replacement below
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size)
+{
+    if (counting_allocations) allocated_bytes += size;
+    if (auto result = std::malloc(size ? size : 1)) return result;
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+// Returns the memory usage of 'value', or nothing if it does not match the memory actually allocated by a copy of it
+static std::optional<std::size_t> count_allocations(const json::value& value)
+{
+    allocated_bytes = 0;
+    counting_allocations = true;
+    json::value copy = value;
+    counting_allocations = false;
+
+    // Copying allocates exactly the heap memory that the copy holds
+    auto usage = json::memory_usage(copy);
+#if defined(__GLIBCXX__)
+    if (usage.total() != allocated_bytes)
+    {
+        std::printf("ERROR: Expected %zu bytes allocated, but memory_usage reported %zu\n", allocated_bytes,
+            usage.total());
+        return std::nullopt;
+    }
+#endif
+
+    return usage.total();
+}
+
+static int memory_usage_scalar_test()
+{
+    test_guard guard{ "memory_usage_scalar_test" };
+
+    for (auto& value : { json::value(), json::value(nullptr), json::value(true), json::value(42.0),
+             json::value(""s), json::value("short"s) })
+    {
+        auto usage = json::memory_usage(value);
+        if (usage.total() || usage.variant_overhead || (count_allocations(value) != std::size_t(0)))
+        {
+            std::printf("ERROR: Expected scalar values to not hold any memory\n");
+            return 1;
+        }
+    }
+
+    std::string longString(100, 'x');
+    json::value value(longString);
+    auto usage = json::memory_usage(value);
+    if ((usage.strings < longString.size()) || (usage.total() != usage.strings) ||
+        (count_allocations(value) != usage.total()))
+    {
+        std::printf("ERROR: Incorrect memory usage for string\n");
+        return 1;
+    }
+
+    return guard.success();
+}
+
+static int memory_usage_container_test()
+{
+    test_guard guard{ "memory_usage_container_test" };
+
+    std::string input = R"^-^({
+        "a_long_member_name_that_does_not_fit_in_the_small_string_buffer": [ 1, true, null, "x", [], {} ],
+        "nested": { "a": { "b": { "c": "another long string that will be allocated on the heap" } } },
+        "numbers": [ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17 ],
+        "empty": {}
+    })^-^";
+    json::buffer_input_stream<char> stream(input);
+    json::lexer lexer(stream);
+    json::value value;
+    if (!json::parse_value(lexer, value))
+    {
+        std::printf("ERROR: Failed to parse value\n");
+        return 1;
+    }
+
+    auto usage = json::memory_usage(value);
+    if (!usage.strings || !usage.array_storage || !usage.object_buckets || !usage.object_nodes ||
+        !usage.variant_overhead)
+    {
+        std::printf("ERROR: Expected all categories to be non-zero\n");
+        return 1;
+    }
+
+    if (usage.array_storage < 24 * sizeof(json::value))
+    {
+        std::printf("ERROR: Array storage does not account for all elements\n");
+        return 1;
+    }
+
+    if (!count_allocations(value)) return 1;
+
+    return guard.success();
+}
+
+int memory_tests()
+{
+    int result = 0;
+    result += memory_usage_scalar_test();
+    result += memory_usage_container_test();
+    return result;
+}
@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <cstdio>
+#include <json.h>
+#include <json_minify.h>
+
+#include "test_guard.h"
+
+using namespace std::literals;
+
+static json::value parse(std::string_view text)
+{
+    json::buffer_input_stream<char> stream(text);
+    json::lexer lexer(stream);
+    json::value result;
+    json::parse_value(lexer, result);
+    return result;
+}
+
+static int minify_test()
+{
+    test_guard guard{ "minify_test" };
+
+    struct
+    {
+        std::string_view input;
+        std::string_view expected;
+    } testCases[] = {
+        { "", "" },
+        { " \t\r\n", "" },
+        { "[ 1, 2, 3 ]", "[1,2,3]" },
+        { "{\n    \"a\": true,\n    \"b\": [ null, -1.5e+3 ]\n}\n", "{\"a\":true,\"b\":[null,-1.5e+3]}" },
+        { R"(  "leading and trailing whitespace"  )", R"("leading and trailing whitespace")" },
+        { R"([ " spaces  inside \t strings " ])", R"([" spaces  inside \t strings "])" },
+        { R"([ "escaped \" quote", "\\", "\\\"" , "\u0041\n" ])", R"(["escaped \" quote","\\","\\\"","\u0041\n"])" },
+        { R"({ "é中😀" : "😀 中 é" })", R"({"é中😀":"😀 中 é"})" },
+        { "[ \"a long string that spans several words\" , \"\\\"\\\"\\\"\\\"\\\"\\\"\\\"\\\"\\\"\" ]",
+            "[\"a long string that spans several words\",\"\\\"\\\"\\\"\\\"\\\"\\\"\\\"\\\"\\\"\"]" },
+    };
+
+    for (auto& test : testCases)
+    {
+        std::string output;
+        if (!json::minify(test.input, output) || (output != test.expected))
+        {
+            std::printf("ERROR: Incorrect result minifying '%.*s': '%s'\n", int(test.input.size()), test.input.data(),
+                output.c_str());
+            return 1;
+        }
+
+        output.clear();
+        if (!test.expected.empty() && (!json::minify(test.input, output, true) || (output != test.expected)))
+        {
+            std::printf("ERROR: Expected '%.*s' to validate\n", int(test.input.size()), test.input.data());
+            return 1;
+        }
+    }
+
+    std::string output = "prefix";
+    if (!json::minify("[ 1 ]", output) || (output != "prefix[1]"))
+    {
+        std::printf("ERROR: Expected minify to append to the output\n");
+        return 1;
+    }
+
+    // The input may refer to the output, which is reallocated as it grows
+    output = "[ 1, 2 ]";
+    if (!json::minify(output, output, true) || (output != "[ 1, 2 ][1,2]") ||
+        !json::minify(std::string_view(output).substr(0, 8), output) || (output != "[ 1, 2 ][1,2][1,2]"))
+    {
+        std::printf("ERROR: Incorrect result minifying part of the output into itself\n");
+        return 1;
+    }
+
+    return guard.success();
+}
+
+static int minify_failure_test()
+{
+    test_guard guard{ "minify_failure_test" };
+
+    // Unterminated strings are always detected
+    for (auto input : { R"([ "abc )"sv, R"([ "abc\" ])"sv, R"("abc\)"sv, "\""sv })
+    {
+        std::string output = "prefix";
+        if (json::minify(input, output) || json::minify(input, output, true) || (output != "prefix"))
+        {
+            std::printf("ERROR: Expected unterminated string in '%.*s' to fail\n", int(input.size()), input.data());
+            return 1;
+        }
+    }
+
+    // Anything else is only detected when validating
+    for (auto input : { ""sv, "{ \"a\": }"sv, "[ 1, 2 ] 3"sv, "tru"sv, "[ 01 ]"sv, "[ \"\\q\" ]"sv, "[ \"a\tb\" ]"sv })
+    {
+        std::string output = "prefix";
+        if (json::minify(input, output, true) || (output != "prefix"))
+        {
+            std::printf("ERROR: Expected '%.*s' to fail validation\n", int(input.size()), input.data());
+            return 1;
+        }
+
+        if (!json::minify(input, output))
+        {
+            std::printf("ERROR: Expected '%.*s' to minify without validation\n", int(input.size()), input.data());
+            return 1;
+        }
+    }
+
+    return guard.success();
+}
+
+static int minify_large_test()
+{
+    test_guard guard{ "minify_large_test" };
+
+    std::string input = "[\n";
+    for (int i = 0; i < 1000; ++i)
+    {
+        if (i != 0) input += ",\n";
+        input += "    {\r\n\t\"id\" : " + std::to_string(i) + ", \"name\": \"item \\\"" + std::to_string(i) +
+            "\\\"\", \"tags\": [ \"a b\", \"\\\\\" ], \"ok\": " + ((i % 2) ? "true" : "false") + " }";
+    }
+    input += "\n]\n";
+
+    std::string output;
+    if (!json::minify(input, output, true) || (parse(output) != parse(input)))
+    {
+        std::printf("ERROR: Minified document does not match the original\n");
+        return 1;
+    }
+
+    // The only whitespace left is the two spaces inside the strings of each item
+    auto whitespace = std::count_if(output.begin(), output.end(), [](char ch) { return json::is_whitespace(ch); });
+    if (whitespace != 2000)
+    {
+        std::printf("ERROR: Expected 2000 whitespace characters in minified document, found %d\n", int(whitespace));
+        return 1;
+    }
+
+    return guard.success();
+}
+
+int minify_tests()
+{
+    int result = 0;
+    result += minify_test();
+    result += minify_failure_test();
+    result += minify_large_test();
+    return result;
+}
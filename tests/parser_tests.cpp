@@ -1,6 +1,8 @@
 
 #include <json_parser.h>
+#include <limits>
 #include <sstream>
+#include <vector>
 
 #include "test_guard.h"
 
@@ -720,6 +722,103 @@ static int parse_object_test()
     return guard.success();
 }
 
+static int parse_number_array_test()
+{
+    test_guard guard{ "parse_number_array_test" };
+
+    auto do_test = [](const std::string& str, auto expected, bool expectSuccess) {
+        using T = typename decltype(expected)::value_type;
+        return run_with_lexer(str, [&](auto& lexer) {
+            std::vector<T> result = { T(99) }; // Should be replaced
+            if (json::parse_number_array(lexer, result) != expectSuccess)
+            {
+                std::printf("ERROR: Incorrectly parsed '%s'\n", str.c_str());
+                return false;
+            }
+
+            if (!expectSuccess) return true;
+            if (result != expected)
+            {
+                std::printf("ERROR: Incorrect values parsed from '%s'\n", str.c_str());
+                return false;
+            }
+            else if (lexer.current_token != json::lexer_token::comma)
+            {
+                std::printf("ERROR: Expected lexer to be positioned after the array for '%s'\n", str.c_str());
+                return false;
+            }
+
+            return true;
+        });
+    };
+
+    bool success = do_test("[],"s, std::vector<int>{}, true) && do_test("[ ] ,"s, std::vector<int>{}, true) &&
+        do_test("[1,2,3],"s, std::vector<int>{ 1, 2, 3 }, true) &&
+        do_test("[ -1 , 0\n,\t42e1, 4.20e1 ] ,"s, std::vector<int>{ -1, 0, 420, 42 }, true) &&
+        do_test("[1.5, -0.25, 1e-3],"s, std::vector<double>{ 1.5, -0.25, 1e-3 }, true) &&
+        do_test("[9007199254740993, -9223372036854775808],"s,
+            std::vector<std::int64_t>{ 9007199254740993, std::numeric_limits<std::int64_t>::min() }, true) &&
+        do_test("[255, 0],"s, std::vector<std::uint8_t>{ 255, 0 }, true) &&
+        do_test("[256]"s, std::vector<std::uint8_t>{}, false) && do_test("[-1]"s, std::vector<unsigned>{}, false) &&
+        do_test("[1.5]"s, std::vector<int>{}, false) && do_test("[1,]"s, std::vector<int>{}, false) &&
+        do_test("[,1]"s, std::vector<int>{}, false) && do_test("[1 2]"s, std::vector<int>{}, false) &&
+        do_test("[1"s, std::vector<int>{}, false) && do_test("[01]"s, std::vector<int>{}, false) &&
+        do_test("[1a]"s, std::vector<int>{}, false) && do_test("[\"1\"]"s, std::vector<int>{}, false) &&
+        do_test("[[1]]"s, std::vector<int>{}, false) && do_test("[null]"s, std::vector<int>{}, false) &&
+        do_test("1"s, std::vector<int>{}, false) && do_test("{}"s, std::vector<int>{}, false);
+    if (!success) return 1;
+
+    // Large arrays
+    std::string large = "[";
+    std::vector<double> expected;
+    for (int i = 0; i < 10000; ++i)
+    {
+        expected.push_back(i * 0.5 - 100);
+        large += std::to_string(i * 0.5 - 100) + ((i == 9999) ? "]," : ", ");
+    }
+
+    if (!do_test(large, expected, true)) return 1;
+
+    return guard.success();
+}
+
+static int parse_number_matrix_test()
+{
+    test_guard guard{ "parse_number_matrix_test" };
+
+    auto do_test = [](const std::string& str, std::vector<double> expected, std::size_t expectedRows,
+                       std::size_t expectedColumns, bool expectSuccess) {
+        return run_with_lexer(str, [&](auto& lexer) {
+            std::vector<double> result;
+            std::size_t rows, columns;
+            if (json::parse_number_matrix(lexer, result, rows, columns) != expectSuccess)
+            {
+                std::printf("ERROR: Incorrectly parsed '%s'\n", str.c_str());
+                return false;
+            }
+
+            if (expectSuccess && ((result != expected) || (rows != expectedRows) || (columns != expectedColumns) ||
+                                     (lexer.current_token != json::lexer_token::eof)))
+            {
+                std::printf("ERROR: Incorrect matrix parsed from '%s'\n", str.c_str());
+                return false;
+            }
+
+            return true;
+        });
+    };
+
+    bool success = do_test("[]"s, {}, 0, 0, true) && do_test("[[]]"s, {}, 1, 0, true) &&
+        do_test("[[1, 2, 3], [4, 5, 6]]"s, { 1, 2, 3, 4, 5, 6 }, 2, 3, true) &&
+        do_test("[ [1.5] , [-2] , [3e2] ]"s, { 1.5, -2, 300 }, 3, 1, true) &&
+        do_test("[[1, 2], [3]]"s, {}, 0, 0, false) && do_test("[[1], [2, 3]]"s, {}, 0, 0, false) &&
+        do_test("[[1], 2]"s, {}, 0, 0, false) && do_test("[1, 2]"s, {}, 0, 0, false) &&
+        do_test("[[1], [2]"s, {}, 0, 0, false) && do_test("[[1], [[2]]]"s, {}, 0, 0, false);
+    if (!success) return 1;
+
+    return guard.success();
+}
+
 int parser_tests()
 {
     int result = 0;
@@ -730,6 +829,8 @@ int parser_tests()
     result += parse_string_test();
     result += parse_number_test();
     result += parse_array_test();
+    result += parse_number_array_test();
+    result += parse_number_matrix_test();
     result += parse_object_test();
     return result;
 }
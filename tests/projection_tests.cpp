@@ -0,0 +1,118 @@
+
+#include <json_projection.h>
+#include <sstream>
+
+#include "test_guard.h"
+
+using namespace std::literals;
+
+template <typename Callback>
+static bool run_with_lexer(const std::string& str, Callback&& callback)
+{
+    json::buffer_input_stream bufferStream(str.data(), str.data() + str.size());
+    json::lexer bufferLexer(bufferStream);
+    if (!callback(bufferLexer)) return false;
+
+    std::stringstream sstream(str);
+    json::istream istream(sstream);
+    json::lexer istreamLexer(istream);
+    if (!callback(istreamLexer)) return false;
+
+    return true;
+}
+
+static int projection_add_test()
+{
+    test_guard guard{ "projection_add_test" };
+
+    json::projection proj;
+    if (!proj.add("/a/b") || !proj.add("/a/c") || !proj.add("/d/0") || !proj.add("/e~1f/g~0h"))
+    {
+        std::printf("ERROR: Failed to add valid paths\n");
+        return 1;
+    }
+
+    if (proj.add("/a/b") || proj.add("/a") || proj.add("/a/b/c") || proj.add("") || proj.add("a") ||
+        proj.add("/x~2"))
+    {
+        std::printf("ERROR: Added duplicate, overlapping, or malformed path\n");
+        return 1;
+    }
+
+    if (proj.size() != 4)
+    {
+        std::printf("ERROR: Expected 4 paths, got %zu\n", proj.size());
+        return 1;
+    }
+
+    return guard.success();
+}
+
+static int projection_run_test()
+{
+    test_guard guard{ "projection_run_test" };
+
+    json::projection proj;
+    proj.add("/user/id");
+    proj.add("/user/name");
+    proj.add("/tags/1");
+    proj.add("/a~1b");
+    proj.add("/missing");
+
+    auto input = R"^-^({
+        "skip": { "user": { "id": 1 } },
+        "user": { "name": "foo", "other": [ 1, 2, { "id": 3 } ], "id": 42 },
+        "tags": [ "zero", "one", "two" ],
+        "a/b": true
+    })^-^"s;
+
+    if (!run_with_lexer(input, [&](auto& lexer) {
+            int id = 0;
+            std::string name, tag;
+            bool flag = false, sawMissing = false;
+            if (!proj.run(lexer, [&](auto& lexer, std::size_t index) {
+                    switch (index)
+                    {
+                    case 0: return json::parse_number(lexer, id);
+                    case 1: return json::parse_string(lexer, name);
+                    case 2: return json::parse_string(lexer, tag);
+                    case 3: return json::parse_bool(lexer, flag);
+                    default: sawMissing = true; return false;
+                    }
+                }))
+            {
+                std::printf("ERROR: Projection failed\n");
+                return false;
+            }
+
+            if ((id != 42) || (name != "foo") || (tag != "one") || !flag || sawMissing)
+            {
+                std::printf("ERROR: Incorrect projected values\n");
+                return false;
+            }
+
+            return lexer.current_token == json::lexer_token::eof;
+        }))
+        return 1;
+
+    // Mismatched types are skipped, but malformed input still fails
+    if (!run_with_lexer(R"^-^({ "user": [ 1, 2 ], "tags": { "2": 42 } })^-^", [&](auto& lexer) {
+            return proj.run(lexer, [](auto&, std::size_t) { return false; });
+        }))
+        return 1;
+
+    if (!run_with_lexer(R"^-^({ "user": { "id": 42 })^-^", [&](auto& lexer) {
+            return !proj.run(lexer, [](auto& lexer, std::size_t) { return json::ignore_value(lexer); });
+        }))
+        return 1;
+
+    return guard.success();
+}
+
+int projection_tests()
+{
+    int result = 0;
+    result += projection_add_test();
+    result += projection_run_test();
+    return result;
+}
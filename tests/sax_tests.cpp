@@ -0,0 +1,179 @@
+
+#include <cmath>
+#include <json_sax.h>
+#include <limits>
+#include <sstream>
+
+#include "test_guard.h"
+
+using namespace std::literals;
+
+template <typename Callback>
+static bool run_with_lexer(const std::string& str, Callback&& callback)
+{
+    json::buffer_input_stream bufferStream(str.data(), str.data() + str.size());
+    json::lexer bufferLexer(bufferStream);
+    if (!callback(bufferLexer)) return false;
+
+    std::stringstream sstream(str);
+    json::istream istream(sstream);
+    json::lexer istreamLexer(istream);
+    if (!callback(istreamLexer)) return false;
+
+    return true;
+}
+
+// Records events as a compact string, e.g. '{k:a,[n:1=1,s:x,b:1,z]}'
+struct recording_handler
+{
+    std::string events;
+    std::size_t fail_after = std::numeric_limits<std::size_t>::max();
+
+    bool record(std::string_view text)
+    {
+        events += text;
+        return --fail_after > 0;
+    }
+
+    bool on_null()
+    {
+        return record("z,");
+    }
+
+    bool on_boolean(bool value)
+    {
+        return record(value ? "b:1," : "b:0,");
+    }
+
+    bool on_number(std::string_view raw, double value)
+    {
+        auto str = std::isinf(value) ? ((value < 0) ? "-inf"s : "inf"s) : std::to_string(static_cast<int>(value));
+        return record("n:"s + std::string(raw) + "=" + str + ",");
+    }
+
+    bool on_string(std::string_view value)
+    {
+        return record("s:"s + std::string(value) + ",");
+    }
+
+    bool on_object_begin()
+    {
+        return record("{");
+    }
+
+    bool on_key(std::string_view key)
+    {
+        return record("k:"s + std::string(key) + ",");
+    }
+
+    bool on_object_end()
+    {
+        return record("}");
+    }
+
+    bool on_array_begin()
+    {
+        return record("[");
+    }
+
+    bool on_array_end()
+    {
+        return record("]");
+    }
+};
+
+static_assert(json::SaxHandler<recording_handler, char>);
+
+static bool check_events(const std::string& input, const std::string& expected)
+{
+    return run_with_lexer(input, [&](auto& lexer) {
+        recording_handler handler;
+        if (!json::sax_parse(lexer, handler) || (lexer.current_token != json::lexer_token::eof))
+        {
+            std::printf("ERROR: Failed to parse '%s'\n", input.c_str());
+            return false;
+        }
+
+        if (handler.events != expected)
+        {
+            std::printf("ERROR: Expected events '%s' for '%s', got '%s'\n", expected.c_str(), input.c_str(),
+                handler.events.c_str());
+            return false;
+        }
+
+        return true;
+    });
+}
+
+static int sax_parse_test()
+{
+    test_guard guard{ "sax_parse_test" };
+
+    if (!check_events("null", "z,") || !check_events("true", "b:1,") || !check_events("\"foo\"", "s:foo,") ||
+        !check_events("4.2e1", "n:4.2e1=42,") || !check_events("{}", "{}") || !check_events("[]", "[]") ||
+        !check_events("[ [], {}, [ [] ] ]", "[[]{}[[]]]") ||
+        !check_events(R"^-^({ "a": [ 1, "x", false, null ], "b": { "c": {} }, "d": -0 })^-^",
+            "{k:a,[n:1=1,s:x,b:0,z,]k:b,{k:c,{}}k:d,n:-0=0,}"))
+        return 1;
+
+    // Numbers out of range for a 'double' are still valid JSON
+    auto huge = "1" + std::string(400, '0');
+    if (!check_events("[ 1e400, -1E+400, 1e-400, 12345e-330, -0.00001e-320, 0.0e-99999999999999999999 ]",
+            "[n:1e400=inf,n:-1E+400=-inf,n:1e-400=0,n:12345e-330=0,n:-0.00001e-320=0,"
+            "n:0.0e-99999999999999999999=0,]") ||
+        !check_events(huge, "n:" + huge + "=inf,") ||
+        !check_events("-" + huge + ".5e-10", "n:-" + huge + ".5e-10=-inf,"))
+        return 1;
+
+    // Deep nesting does not recurse
+    std::string deep = std::string(100000, '[') + std::string(100000, ']');
+    if (!run_with_lexer(deep, [](auto& lexer) {
+            recording_handler handler;
+            return json::sax_parse(lexer, handler) && (handler.events.size() == 200000);
+        }))
+    {
+        std::printf("ERROR: Failed to parse deeply nested input\n");
+        return 1;
+    }
+
+    return guard.success();
+}
+
+static int sax_parse_failure_test()
+{
+    test_guard guard{ "sax_parse_failure_test" };
+
+    for (auto input : { "", "[", "[ 1, ]", "[ 1 2 ]", "{ \"a\" }", "{ \"a\": 1, }", "{ 1: 2 }", "[ 1 }", "{ \"a\": 1 ]",
+             "}", ":" })
+    {
+        if (!run_with_lexer(input, [](auto& lexer) {
+                recording_handler handler;
+                return !json::sax_parse(lexer, handler);
+            }))
+        {
+            std::printf("ERROR: Expected '%s' to fail\n", input);
+            return 1;
+        }
+    }
+
+    // Handlers can stop parsing early
+    if (!run_with_lexer(R"^-^({ "a": [ 1, 2, 3 ] })^-^", [](auto& lexer) {
+            recording_handler handler;
+            handler.fail_after = 4;
+            return !json::sax_parse(lexer, handler) && (handler.events == "{k:a,[n:1=1,");
+        }))
+    {
+        std::printf("ERROR: Expected handler failure to stop parsing\n");
+        return 1;
+    }
+
+    return guard.success();
+}
+
+int sax_tests()
+{
+    int result = 0;
+    result += sax_parse_test();
+    result += sax_parse_failure_test();
+    return result;
+}
@@ -0,0 +1,115 @@
+
+#include <json_schema.h>
+#include <sstream>
+
+#include "test_guard.h"
+
+using namespace std::literals;
+namespace schema = json::schema;
+
+template <typename Callback>
+static bool run_with_lexer(const std::string& str, Callback&& callback)
+{
+    json::buffer_input_stream bufferStream(str.data(), str.data() + str.size());
+    json::lexer bufferLexer(bufferStream);
+    if (!callback(bufferLexer)) return false;
+
+    std::stringstream sstream(str);
+    json::istream istream(sstream);
+    json::lexer istreamLexer(istream);
+    if (!callback(istreamLexer)) return false;
+
+    return true;
+}
+
+template <typename Schema>
+static bool check_schema(const std::string& input, bool expected)
+{
+    return run_with_lexer(input, [&](auto& lexer) {
+        auto result = schema::validate<Schema>(lexer) && (lexer.current_token == json::lexer_token::eof);
+        if (result != expected)
+        {
+            std::printf("ERROR: Expected '%s' to %s validation\n", input.c_str(), expected ? "pass" : "fail");
+            return false;
+        }
+
+        return true;
+    });
+}
+
+static int schema_scalar_test()
+{
+    test_guard guard{ "schema_scalar_test" };
+
+    bool success = check_schema<schema::null>("null", true) && check_schema<schema::null>("false", false) &&
+                   check_schema<schema::boolean>("true", true) && check_schema<schema::boolean>("false", true) &&
+                   check_schema<schema::boolean>("0", false) && check_schema<schema::string>("\"foo\"", true) &&
+                   check_schema<schema::string>("42", false) && check_schema<schema::number<>>("-4.2e1", true) &&
+                   check_schema<schema::number<>>("\"42\"", false) && check_schema<schema::any>("[ {} ]", true) &&
+                   check_schema<schema::any>("[ {} ", false);
+
+    // Ranges
+    success = success && check_schema<schema::number<0, 1>>("0.5", true) &&
+              check_schema<schema::number<0, 1>>("1", true) && check_schema<schema::number<0, 1>>("1.5", false) &&
+              check_schema<schema::number<0, 1>>("-0.1", false) && check_schema<schema::integer<>>("42", true) &&
+              check_schema<schema::integer<>>("4.2e1", true) && check_schema<schema::integer<>>("4.2", false) &&
+              check_schema<schema::integer<-5, 5>>("-5", true) && check_schema<schema::integer<-5, 5>>("6", false) &&
+              check_schema<schema::integer<>>("9223372036854775807", true) &&
+              check_schema<schema::integer<>>("9223372036854775808", false);
+
+    // Enums
+    using color = schema::string_enum<"red", "green", "blue">;
+    success = success && check_schema<color>("\"green\"", true) && check_schema<color>("\"Green\"", false) &&
+              check_schema<color>("\"\"", false) && check_schema<color>("1", false);
+
+    return success ? guard.success() : 1;
+}
+
+static int schema_container_test()
+{
+    test_guard guard{ "schema_container_test" };
+
+    using numbers = schema::array<schema::integer<0, 9>, 1, 3>;
+    bool success = check_schema<numbers>("[ 1 ]", true) && check_schema<numbers>("[ 1, 2, 3 ]", true) &&
+                   check_schema<numbers>("[]", false) && check_schema<numbers>("[ 1, 2, 3, 4 ]", false) &&
+                   check_schema<numbers>("[ 1, 10 ]", false) && check_schema<numbers>("[ 1, \"2\" ]", false) &&
+                   check_schema<numbers>("{}", false);
+
+    using user = schema::object<schema::property<"id", schema::integer<1>>,
+        schema::property<"role", schema::string_enum<"admin", "user">>,
+        schema::property<"tags", schema::array<schema::string>, false>,
+        schema::property<"manager", schema::object<schema::property<"id", schema::integer<1>>>, false>>;
+
+    success = success && check_schema<user>(R"^-^({ "id": 1, "role": "admin" })^-^", true) &&
+              check_schema<user>(R"^-^({ "role": "user", "extra": [ {} ], "id": 2, "tags": [] })^-^", true) &&
+              check_schema<user>(R"^-^({ "id": 1, "role": "user", "manager": { "id": 3 } })^-^", true) &&
+              check_schema<user>(R"^-^({ "id": 1 })^-^", false) &&
+              check_schema<user>(R"^-^({ "id": 0, "role": "admin" })^-^", false) &&
+              check_schema<user>(R"^-^({ "id": 1, "role": "guest" })^-^", false) &&
+              check_schema<user>(R"^-^({ "id": 1, "role": "user", "tags": [ 1 ] })^-^", false) &&
+              check_schema<user>(R"^-^({ "id": 1, "role": "user", "manager": {} })^-^", false) &&
+              check_schema<user>(R"^-^({ "id": 1, "role": "user", "id": 1 })^-^", false) &&
+              check_schema<user>(R"^-^({ "id": 1, "role": "user", "extra": [ })^-^", false) &&
+              check_schema<user>(R"^-^([ { "id": 1, "role": "user" } ])^-^", false);
+
+    // Validation stops at the first violation
+    success = success && run_with_lexer(R"^-^({ "id": 0, "role": "admin" })^-^", [](auto& lexer) {
+        if (schema::validate<user>(lexer) || (lexer.current_token != json::lexer_token::comma))
+        {
+            std::printf("ERROR: Expected validation to stop after the invalid id\n");
+            return false;
+        }
+
+        return true;
+    });
+
+    return success ? guard.success() : 1;
+}
+
+int schema_tests()
+{
+    int result = 0;
+    result += schema_scalar_test();
+    result += schema_container_test();
+    return result;
+}
@@ -0,0 +1,197 @@
+
+#include <json_shared.h>
+#include <sstream>
+
+#include "test_guard.h"
+
+using namespace std::literals;
+
+template <typename Callback>
+static bool run_with_lexer(const std::string& str, Callback&& callback)
+{
+    json::buffer_input_stream bufferStream(str.data(), str.data() + str.size());
+    json::lexer bufferLexer(bufferStream);
+    if (!callback(bufferLexer)) return false;
+
+    std::stringstream sstream(str);
+    json::istream istream(sstream);
+    json::lexer istreamLexer(istream);
+    if (!callback(istreamLexer)) return false;
+
+    return true;
+}
+
+static const std::string test_document = R"^-^({
+    "user": { "id": 42, "name": "foo", "admin": false, "manager": null },
+    "tags": [ "a", "b", "c" ],
+    "a/b": { "c~d": [ 1, 2 ] }
+})^-^";
+
+static int shared_value_parse_test()
+{
+    test_guard guard{ "shared_value_parse_test" };
+
+    if (!run_with_lexer(test_document, [](auto& lexer) {
+            json::shared_value value;
+            if (!json::parse_value(lexer, value) || (lexer.current_token != json::lexer_token::eof))
+            {
+                std::printf("ERROR: Failed to parse value\n");
+                return false;
+            }
+
+            auto obj = value.get_object();
+            auto user = obj ? json::object_get_as<json::shared_object>(*obj, "user") : nullptr;
+            if (!user)
+            {
+                std::printf("ERROR: Expected an object with member 'user'\n");
+                return false;
+            }
+
+            auto id = json::object_get_as<json::number>(*user, "id");
+            auto name = json::object_get_as<json::string>(*user, "name");
+            auto admin = json::object_get_as<json::boolean>(*user, "admin");
+            auto manager = json::object_get_as<json::null>(*user, "manager");
+            if (!id || (*id != 42) || !name || (*name != "foo") || !admin || *admin || !manager ||
+                json::object_get(*user, "missing") ||
+                (json::object_get_as<json::string>(*user, json::key("name")) != name) ||
+                json::object_get(*user, json::key("missing")))
+            {
+                std::printf("ERROR: Incorrect member values\n");
+                return false;
+            }
+
+            auto tag = value.find("/tags/2");
+            auto nested = value.find("/a~1b/c~0d/1");
+            if (!tag || !tag->get_string() || (*tag->get_string() != "c") || !nested || !nested->get_number() ||
+                (*nested->get_number() != 2) || value.find("/tags/3") || value.find("/user/id/0") ||
+                (value.find("") != &value))
+            {
+                std::printf("ERROR: Incorrect pointer lookups\n");
+                return false;
+            }
+
+            return true;
+        }))
+        return 1;
+
+    if (!run_with_lexer(R"^-^({ "a": 1, "a": 2 })^-^", [](auto& lexer) {
+            json::shared_value value;
+            return !json::parse_value(lexer, value);
+        }))
+        return 1;
+
+    return guard.success();
+}
+
+static int shared_value_sharing_test()
+{
+    test_guard guard{ "shared_value_sharing_test" };
+
+    json::buffer_input_stream<char> stream(test_document);
+    json::lexer lexer(stream);
+    json::shared_value original;
+    if (!json::parse_value(lexer, original))
+    {
+        std::printf("ERROR: Failed to parse value\n");
+        return 1;
+    }
+
+    auto copy = original;
+    if (copy.data != original.data)
+    {
+        std::printf("ERROR: Expected copies to share data\n");
+        return 1;
+    }
+
+    if (!copy.set("/user/name", "bar"s) || !copy.set("/tags/-", "d"s) || !copy.set("/user/email", "x@y.z"s))
+    {
+        std::printf("ERROR: Failed to set values\n");
+        return 1;
+    }
+
+    // The original is unmodified
+    if ((*original.find("/user/name")->get_string() != "foo") || original.find("/tags/3") ||
+        original.find("/user/email"))
+    {
+        std::printf("ERROR: Modifying a copy modified the original\n");
+        return 1;
+    }
+
+    if ((*copy.find("/user/name")->get_string() != "bar") || (*copy.find("/tags/3")->get_string() != "d") ||
+        (*copy.find("/user/email")->get_string() != "x@y.z"))
+    {
+        std::printf("ERROR: Incorrect values after set\n");
+        return 1;
+    }
+
+    // Only the containers along the modified paths were copied
+    if ((copy.data == original.data) || (copy.find("/user")->data == original.find("/user")->data) ||
+        (copy.find("/user/id")->data != original.find("/user/id")->data) ||
+        (copy.find("/tags/0")->data != original.find("/tags/0")->data) ||
+        (copy.find("/a~1b")->data != original.find("/a~1b")->data))
+    {
+        std::printf("ERROR: Expected unmodified values to be shared\n");
+        return 1;
+    }
+
+    // Failures leave the value unmodified
+    auto data = copy.data;
+    if (copy.set("/missing/name", 1.0) || copy.set("/tags/5", 1.0) || copy.set("/tags/-/0", 1.0) ||
+        copy.set("/user/id/0", 1.0) || copy.set("user", 1.0) || (copy.data != data))
+    {
+        std::printf("ERROR: Expected invalid paths to fail\n");
+        return 1;
+    }
+
+    // Replacing the root
+    if (!copy.set("", 42.0) || !copy.get_number() || (*copy.get_number() != 42))
+    {
+        std::printf("ERROR: Failed to replace the root\n");
+        return 1;
+    }
+
+    return guard.success();
+}
+
+static int shared_value_conversion_test()
+{
+    test_guard guard{ "shared_value_conversion_test" };
+
+    json::buffer_input_stream<char> stream(test_document);
+    json::lexer lexer(stream);
+    json::value value;
+    if (!json::parse_value(lexer, value))
+    {
+        std::printf("ERROR: Failed to parse value\n");
+        return 1;
+    }
+
+    json::shared_value shared(value);
+    auto roundTrip = shared.to_value();
+    auto user = json::object_get_as<json::object>(*roundTrip.get_object(), "user");
+    auto tags = json::object_get_as<json::array>(*roundTrip.get_object(), "tags");
+    if (!user || (*json::object_get_as<json::string>(*user, "name") != "foo") ||
+        !json::object_get_as<json::null>(*user, "manager") || !tags || (tags->size() != 3) ||
+        (*(*tags)[1].get_string() != "b") || (*shared.find("/a~1b/c~0d/0")->get_number() != 1))
+    {
+        std::printf("ERROR: Incorrect values after conversion\n");
+        return 1;
+    }
+
+    if (json::shared_value().get_null() || json::shared_value().to_value().get_null())
+    {
+        std::printf("ERROR: Expected empty values to have no type\n");
+        return 1;
+    }
+
+    return guard.success();
+}
+
+int shared_value_tests()
+{
+    int result = 0;
+    result += shared_value_parse_test();
+    result += shared_value_sharing_test();
+    result += shared_value_conversion_test();
+    return result;
+}
@@ -0,0 +1,259 @@
+
+#include <cstdio>
+#include <json_snapshot.h>
+
+#include "test_guard.h"
+
+using namespace std::literals;
+
+static json::value parse(std::string_view text)
+{
+    json::buffer_input_stream<char> stream(text);
+    json::lexer lexer(stream);
+    json::value result;
+    json::parse_value(lexer, result);
+    return result;
+}
+
+static constexpr std::string_view test_document = R"^-^({
+    "null": null,
+    "true": true,
+    "false": false,
+    "numbers": [ 0, -1, 1.5, 9007199254740993, -1.7976931348623157e308, -1 ],
+    "strings": [ "", "foo", "é中😀", "foo" ],
+    "users": [
+        { "name": "alice", "id": 1, "tags": [ "admin", "dev" ] },
+        { "name": "bob", "id": 2, "tags": [] }
+    ],
+    "nested": { "z": { "y": { "x": "w" } }, "a": {}, "m": [ [ [] ] ] }
+})^-^";
+
+static int snapshot_round_trip_test()
+{
+    test_guard guard{ "snapshot_round_trip_test" };
+
+    auto original = parse(test_document);
+    std::vector<std::uint8_t> bytes;
+    if (!json::snapshot_encode(original, bytes))
+    {
+        std::printf("ERROR: Failed to encode snapshot\n");
+        return 1;
+    }
+
+    json::snapshot doc(bytes);
+    json::value decoded;
+    if (!doc || !doc.root().to_value(decoded) || (decoded != original))
+    {
+        std::printf("ERROR: Snapshot did not round trip\n");
+        return 1;
+    }
+
+    // Scalar roots, and snapshots appended after existing data
+    for (auto& val : { json::value(nullptr), json::value(true), json::value(42.0), json::value("str"s), json::value() })
+    {
+        std::vector<std::uint8_t> prefixed = { 1, 2, 3 };
+        json::snapshot_encode(val, prefixed);
+        json::snapshot scalarDoc{ std::span(prefixed).subspan(3) };
+        if (!scalarDoc || !scalarDoc.root().to_value(decoded) || (decoded != val))
+        {
+            std::printf("ERROR: Scalar snapshot did not round trip\n");
+            return 1;
+        }
+    }
+
+    return guard.success();
+}
+
+static int snapshot_query_test()
+{
+    test_guard guard{ "snapshot_query_test" };
+
+    std::vector<std::uint8_t> bytes;
+    json::snapshot_encode(parse(test_document), bytes);
+    auto root = json::snapshot(bytes).root();
+
+    auto bob = root.find("/users/1/name");
+    auto id = root.find("/users/0/id");
+    auto deep = root.find("/nested/z/y/x");
+    if (!bob || (bob->get_string() != "bob") || !id || (id->get_number() != 1.0) || !deep ||
+        (deep->get<std::string_view>() != "w"))
+    {
+        std::printf("ERROR: Incorrect result from 'find'\n");
+        return 1;
+    }
+
+    if (root.find("/users/2") || root.find("/missing") || root.find("/null/x") || root.find("users") ||
+        !root.find("")->get_object() || !root.find("/null")->is_null() || (root.find("/true")->get_boolean() != true) ||
+        (root.find("/false")->get_boolean() != false) || root.find("/true")->get_number())
+    {
+        std::printf("ERROR: Incorrect result from 'find' for missing values or mismatched types\n");
+        return 1;
+    }
+
+    auto obj = *root.get_object();
+    auto users = json::object_get_as<json::snapshot_array>(obj, "users");
+    if (!users || (users->size() != 2) || (*users)[2].valid() ||
+        (json::object_get_as<std::string_view>(*(*users)[0].get_object(), "name") != "alice"sv) ||
+        json::object_get(obj, "nothing") || !json::object_get(obj, "nested") ||
+        (json::object_get_as<json::snapshot_array>(obj, json::key("users"))->size() != 2) ||
+        json::object_get(obj, json::key("nothing")))
+    {
+        std::printf("ERROR: Incorrect result from 'object_get'\n");
+        return 1;
+    }
+
+    // Keys are sorted
+    for (std::size_t i = 1; i < obj.size(); ++i)
+    {
+        if (!(*obj.key(i - 1) < *obj.key(i)))
+        {
+            std::printf("ERROR: Object keys are not sorted\n");
+            return 1;
+        }
+    }
+
+    // Numbers keep their original text
+    if ((root.find("/numbers/3")->get_number_text() != "9007199254740993") ||
+        (root.find("/numbers/3")->get_number()->get<std::int64_t>() != 9007199254740993))
+    {
+        std::printf("ERROR: Expected numbers to be lossless\n");
+        return 1;
+    }
+
+    // Identical strings and numbers are only stored once
+    auto strings = *root.find("/strings")->get_array();
+    auto numbers = *root.find("/numbers")->get_array();
+    if ((strings[1].get_string()->data() != strings[3].get_string()->data()) ||
+        (numbers[1].get_number_text()->data() != numbers[5].get_number_text()->data()))
+    {
+        std::printf("ERROR: Expected identical strings and numbers to be deduplicated\n");
+        return 1;
+    }
+
+    return guard.success();
+}
+
+// Visits every value, returning false if any data is invalid
+static bool walk(const json::snapshot_value& val)
+{
+    if (!val.valid()) return false;
+    if (auto arr = val.get_array())
+    {
+        for (std::size_t i = 0; i < arr->size(); ++i)
+        {
+            if (!walk((*arr)[i])) return false;
+        }
+    }
+    else if (auto obj = val.get_object())
+    {
+        for (std::size_t i = 0; i < obj->size(); ++i)
+        {
+            if (!obj->key(i) || !walk(obj->value_at(i))) return false;
+            if (!obj->find(*obj->key(i))) return false;
+        }
+    }
+
+    return true;
+}
+
+static int snapshot_corruption_test()
+{
+    test_guard guard{ "snapshot_corruption_test" };
+
+    std::vector<std::uint8_t> bytes;
+    json::snapshot_encode(parse(test_document), bytes);
+
+    // Truncated input is either rejected outright, or fails when accessed; it must never read out of bounds
+    for (std::size_t size = 0; size < bytes.size(); ++size)
+    {
+        std::vector<std::uint8_t> truncated(bytes.begin(), bytes.begin() + size);
+        json::snapshot doc(truncated);
+        if (doc)
+        {
+            std::printf("ERROR: Expected truncated snapshot to be rejected\n");
+            return 1;
+        }
+    }
+
+    // Arbitrary modifications, with the header intact. With sanitizers, this checks that all reads are in bounds
+    for (std::size_t pos = json::details::snapshot_header_size; pos < bytes.size(); ++pos)
+    {
+        for (std::uint8_t delta : { 1, 8, 0x80 })
+        {
+            auto corrupt = bytes;
+            corrupt[pos] ^= delta;
+            json::snapshot doc(corrupt);
+            json::value ignored;
+            walk(doc.root());
+            doc.root().to_value(ignored);
+        }
+    }
+
+    // A container that refers to itself is rejected, rather than recursing forever
+    std::vector<std::uint8_t> cyclic;
+    json::snapshot_encode(json::array{ json::array{} }, cyclic);
+    auto rootOffset = cyclic[12] & ~7;
+    cyclic[rootOffset + 4] = cyclic[12]; // The inner array now refers to the root
+    json::value ignored;
+    if (json::snapshot(cyclic).root().to_value(ignored))
+    {
+        std::printf("ERROR: Expected cyclic snapshot to be rejected\n");
+        return 1;
+    }
+
+    bytes[0] = 'X';
+    if (json::snapshot(bytes) || json::snapshot(bytes).root().valid())
+    {
+        std::printf("ERROR: Expected snapshot with invalid magic to be rejected\n");
+        return 1;
+    }
+
+    return guard.success();
+}
+
+static int mapped_file_test()
+{
+    test_guard guard{ "mapped_file_test" };
+
+    auto path = "mapped_file_test.snapshot";
+    std::vector<std::uint8_t> bytes;
+    json::snapshot_encode(parse(test_document), bytes);
+    if (auto file = std::fopen(path, "wb"))
+    {
+        std::fwrite(bytes.data(), 1, bytes.size(), file);
+        std::fclose(file);
+    }
+
+    auto result = [&] {
+        json::mapped_file file(path);
+        json::snapshot doc(file.bytes());
+        auto name = doc.root().find("/users/0/tags/1");
+        if (!file.is_open() || !doc || !name || (name->get_string() != "dev"))
+        {
+            std::printf("ERROR: Failed to query mapped snapshot\n");
+            return false;
+        }
+
+        json::mapped_file missing("mapped_file_test.missing");
+        if (missing.is_open() || !missing.bytes().empty() || json::snapshot(missing.bytes()))
+        {
+            std::printf("ERROR: Expected missing file to fail to open\n");
+            return false;
+        }
+
+        return true;
+    }();
+
+    std::remove(path);
+    return result ? guard.success() : 1;
+}
+
+int snapshot_tests()
+{
+    int result = 0;
+    result += snapshot_round_trip_test();
+    result += snapshot_query_test();
+    result += snapshot_corruption_test();
+    result += mapped_file_test();
+    return result;
+}
@@ -1,5 +1,6 @@
 
 #include <json.h>
+#include <limits>
 #include <sstream>
 
 #include "test_guard.h"
@@ -145,9 +146,184 @@ static int parse_value_test()
     return guard.success();
 }
 
+static int value_equality_test()
+{
+    test_guard guard{ "value_equality_test" };
+
+    auto input = R"^-^({
+        "name": "foo",
+        "zero": 0,
+        "list": [ 1, "two", [ null, true ] ],
+        "nested": { "a": 1, "b": { "c": [ false ] } }
+    })^-^"s;
+    auto reordered = R"^-^({
+        "nested": { "b": { "c": [ false ] }, "a": 1 },
+        "list": [ 1, "two", [ null, true ] ],
+        "zero": -0,
+        "name": "foo"
+    })^-^"s;
+
+    json::buffer_input_stream<char> stream(input);
+    json::lexer lexer(stream);
+    json::value value;
+    json::buffer_input_stream<char> reorderedStream(reordered);
+    json::lexer reorderedLexer(reorderedStream);
+    json::value reorderedValue;
+    if (!json::parse_value(lexer, value) || !json::parse_value(reorderedLexer, reorderedValue))
+    {
+        std::printf("ERROR: Failed to parse value\n");
+        return 1;
+    }
+
+    if ((value != reorderedValue) || (json::hash(value) != json::hash(reorderedValue)) || (value != value))
+    {
+        std::printf("ERROR: Expected reordered objects to be equal and hash the same\n");
+        return 1;
+    }
+
+    auto check_different = [&](const char* what, auto&& modify) {
+        json::value copy = value;
+        modify(*copy.get_object());
+        if ((copy == value) || (json::hash(copy) == json::hash(value)))
+        {
+            std::printf("ERROR: Expected modification of %s to make values unequal\n", what);
+            return false;
+        }
+
+        return true;
+    };
+
+    if (!check_different("string", [](json::object& obj) { obj["name"] = "bar"; }) ||
+        !check_different("type", [](json::object& obj) { obj["zero"] = false; }) ||
+        !check_different("array order", [](json::object& obj) {
+            auto& list = *obj["list"].get_array();
+            std::swap(list[0], list[1]);
+        }) ||
+        !check_different("array size", [](json::object& obj) { obj["list"].get_array()->resize(4); }) ||
+        !check_different("member name", [](json::object& obj) {
+            auto& nested = *obj["nested"].get_object();
+            nested["x"] = std::move(nested["a"]);
+            nested.erase("a");
+        }) ||
+        !check_different("nested value", [](json::object& obj) {
+            auto& c = *obj["nested"].get_object()->at("b").get_object()->at("c").get_array();
+            c[0] = true;
+        }))
+        return 1;
+
+    if ((json::value() != json::value()) || (json::value() == json::value(nullptr)) ||
+        (json::value(json::array{}) == json::value(json::object{})) ||
+        (json::hash(json::value(json::array{})) == json::hash(json::value(json::object{}))))
+    {
+        std::printf("ERROR: Incorrect comparison of empty values\n");
+        return 1;
+    }
+
+    return guard.success();
+}
+
+static int number_test()
+{
+    test_guard guard{ "number_test" };
+
+    auto input = R"^-^([ 18446744073709551615, 9007199254740993, -9223372036854775808, 1.5, 4.2e1, 1e400 ])^-^"s;
+    json::buffer_input_stream<char> stream(input);
+    json::lexer lexer(stream);
+    json::value value;
+    if (!json::parse_value(lexer, value))
+    {
+        std::printf("ERROR: Failed to parse value\n");
+        return 1;
+    }
+
+    auto& arr = *value.get_array();
+    auto number = [&](std::size_t index) { return *arr[index].get_number(); };
+    if ((number(0).get<std::uint64_t>() != 18446744073709551615ull) || number(0).get<std::int64_t>() ||
+        (number(1).get<std::int64_t>() != 9007199254740993) || (number(1).get<double>() != 9007199254740992.0) ||
+        (number(2).get<std::int64_t>() != std::numeric_limits<std::int64_t>::min()) || number(3).get<int>() ||
+        (number(3).get<double>() != 1.5) || (number(4).get<int>() != 42) || number(5).get<double>() ||
+        (number(5).text() != "1e400"))
+    {
+        std::printf("ERROR: Incorrect conversion of numbers\n");
+        return 1;
+    }
+
+    if (!number(0).is_integral() || number(3).is_integral() || number(4).is_integral())
+    {
+        std::printf("ERROR: Incorrect result from 'is_integral'\n");
+        return 1;
+    }
+
+    // Numbers compare by value, except that 64-bit integers are compared exactly
+    auto sameHash = [](const json::number& lhs, const json::number& rhs) {
+        return json::hash(json::value(lhs)) == json::hash(json::value(rhs));
+    };
+    if ((json::number(42) != number(4)) || !sameHash(json::number(42), number(4)) || (json::number(1.5) != 1.5) ||
+        (json::number::from_text("-0") != json::number(0.0)) || !sameHash(json::number::from_text("-0"), 0) ||
+        (json::number::from_text("9007199254740992") == number(1)) ||
+        (json::number(std::numeric_limits<double>::quiet_NaN()) == number(5)))
+    {
+        std::printf("ERROR: Incorrect result from number comparison\n");
+        return 1;
+    }
+
+    // Equality is transitive: a number that is exactly a 64-bit integer only equals the same integer
+    auto large = json::number::from_text("9007199254740992");
+    auto largeFraction = json::number::from_text("9007199254740992.0");
+    if ((large != largeFraction) || (number(1) == largeFraction) || (number(1) == large) ||
+        (json::number::from_text("1e2") != json::number(100)) || json::number::from_text("5e19").get<std::uint64_t>() ||
+        (json::number::from_text("1e30") != json::number::from_text("1000000000000000000000000000000")))
+    {
+        std::printf("ERROR: Number comparison is not transitive\n");
+        return 1;
+    }
+
+    // Numbers created from native types use the shortest text that round trips
+    if ((json::number(1.5).text() != "1.5") || (json::number(-7).text() != "-7") || !json::number(-7).is_integral() ||
+        (json::number(0.1).get<double>() != 0.1) || (json::number().text() != "0"))
+    {
+        std::printf("ERROR: Incorrect text for numbers created from native types\n");
+        return 1;
+    }
+
+    return guard.success();
+}
+
+static int key_test()
+{
+    test_guard guard{ "key_test" };
+
+    json::object obj = { { "id", 42.0 }, { "name", "foo"s }, { "", true } };
+    const auto& constObj = obj;
+    const json::key idKey("id");
+    const json::key nameKey("name");
+    const json::key emptyKey("");
+    const json::key missingKey("missing");
+    if ((idKey.hash() != json::details::string_hash{}("id"sv)) || (idKey.view() != "id") || !(idKey == "id"sv) ||
+        (idKey == "name"sv))
+    {
+        std::printf("ERROR: Incorrect key properties\n");
+        return 1;
+    }
+
+    if ((json::object_get(obj, idKey) != &obj["id"]) || (json::object_get(constObj, nameKey) != &obj["name"]) ||
+        (json::object_get_as<json::boolean>(obj, emptyKey) != obj[""].get_boolean()) ||
+        (json::object_get_as<json::string>(constObj, nameKey) != obj["name"].get_string()) ||
+        json::object_get(obj, missingKey) || json::object_get_as<json::string>(obj, idKey))
+    {
+        std::printf("ERROR: Incorrect result from lookup by key\n");
+        return 1;
+    }
+
+    return guard.success();
+}
+
 int value_tests()
 {
     int result = 0;
     result += parse_value_test();
+    result += value_equality_test();
+    result += number_test();
+    result += key_test();
     return result;
 }